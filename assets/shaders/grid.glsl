@@ -0,0 +1,109 @@
+#version 330 core
+
+// 地面（y = 0）の無限グリッド。画面全体の三角形 1 枚を描き、画素ごとに視線と平面の交点を求める
+// 線の数に関係なく 1 画素あたりの計算量は一定（頂点バッファも持たない）
+
+// フレームごとのカメラ（FrameUniforms と同じ並び）
+layout(std140) uniform Frame
+{
+	mat4 uView;
+	mat4 uProj;
+	mat4 uViewProj;
+	mat4 uInvViewProj;
+	vec4 uViewport;		// x, y, 幅, 高さ
+	vec4 uTime;			// 経過秒, 前フレームからの秒, フレーム番号, 0
+};
+
+#ifdef VERTEX
+// 視線の両端（ワールド座標の同次座標）。画面全体の三角形は w = 1 なので線形補間で正しい
+out vec4 vNear;
+out vec4 vFar;
+flat out vec3 vEye;
+
+void main()
+{
+	// gl_VertexID 0, 1, 2 → (-1, -1), (3, -1), (-1, 3)
+	vec2 ndc = vec2(gl_VertexID == 1 ? 3.0 : -1.0, gl_VertexID == 2 ? 3.0 : -1.0);
+	vNear = uInvViewProj * vec4(ndc, -1.0, 1.0);
+	vFar = uInvViewProj * vec4(ndc, 1.0, 1.0);
+
+	// 剛体のビュー行列なので逆行列の平行移動は -R^T t
+	vEye = -transpose(mat3(uView)) * uView[3].xyz;
+
+	gl_Position = vec4(ndc, 0.0, 1.0);
+}
+#endif
+
+#ifdef FRAGMENT
+in vec4 vNear;
+in vec4 vFar;
+flat in vec3 vEye;
+
+// OrbitCamera::distance()。細かい線の間隔と遠くで消える距離を決める
+uniform float uCameraDistance = 5.0;
+
+out vec4 FragColor;
+
+// spacing 間隔の線の濃さ [0, 1]。線幅は 1 画素で、fwidth で画面上の太さを保つ
+float gridLine(vec2 p, float spacing)
+{
+	vec2 c = p / spacing;
+	vec2 w = fwidth(c);
+	vec2 d = abs(fract(c - 0.5) - 0.5) / w;		// 最寄りの線までの画素数
+	float line = 1.0 - min(min(d.x, d.y), 1.0);
+
+	// 間隔が 2〜3 画素を切るとモアレになるので、その前に消す
+	return line * (1.0 - smoothstep(0.3, 0.5, max(w.x, w.y)));
+}
+
+// 軸（座標が 0 の線）の濃さ。普通の線より少し太く
+float axisLine(float coord)
+{
+	return 1.0 - min(abs(coord) / (1.5 * fwidth(coord)), 1.0);
+}
+
+void main()
+{
+	vec3 nearPos = vNear.xyz / vNear.w;
+	vec3 farPos = vFar.xyz / vFar.w;
+	vec3 dir = farPos - nearPos;
+
+	// 平面と交わらない（水平線より上・平行）画素は最後に捨てる
+	// fwidth は分岐の外で求める必要があるので、ここでは discard しない
+	float t = dir.y != 0.0 ? -nearPos.y / dir.y : -1.0;
+	vec3 hit = nearPos + max(t, 0.0) * dir;
+	vec4 clip = uViewProj * vec4(hit, 1.0);
+	float depth = clip.z / clip.w * 0.5 + 0.5;
+
+	// 間隔は 10 倍ずつ。lod が上がるにつれて一番細かい段が消え、次の段が太い線へ移っていく
+	// 段 k の強さは k - lod だけで決まるので、段が切り替わるときに不連続にならない
+	float lod = log(max(uCameraDistance, 1e-3)) / log(10.0) - 1.0;
+	float level = floor(lod);
+	vec2 p = hit.xz;
+
+	float alpha = 0.0;
+	for (int i = 0; i < 3; ++i)
+	{
+		float k = level + float(i);
+		float u = k - lod + 1.0;	// (0, 1]: 細かい段（消えていく）、(1, 2]: 普通、2 以上: 太い段
+		float strength = 0.35 * clamp(u, 0.0, 1.0) + 0.35 * clamp(u - 1.0, 0.0, 1.0);
+		alpha = max(alpha, gridLine(p, pow(10.0, k)) * strength);
+	}
+	vec3 color = vec3(0.55, 0.55, 0.60);
+
+	// X 軸（z = 0）は赤、Z 軸（x = 0）は青
+	float axisX = axisLine(p.y);
+	float axisZ = axisLine(p.x);
+	color = mix(color, vec3(0.90, 0.20, 0.20), axisX);
+	color = mix(color, vec3(0.20, 0.35, 0.90), axisZ);
+	alpha = max(alpha, max(axisX, axisZ));
+
+	// カメラから離れるほど薄く（水平線近くのちらつきも隠す）
+	float fade = 1.0 - smoothstep(5.0 * uCameraDistance, 25.0 * uCameraDistance, length(hit.xz - vEye.xz));
+	alpha *= fade;
+	if (t <= 0.0 || depth >= 1.0 || alpha <= 0.0) discard;
+
+	gl_FragDepth = depth;
+	FragColor = vec4(color, alpha);
+}
+#endif
@@ -1,15 +1,89 @@
 #version 330 core
 
+// 機能（ShaderVariants のビット。Renderer::LineFeature と同じ並び）
+//   INSTANCED          : インスタンス属性のモデル行列・色
+//   PACKED_VERTEX      : 圧縮頂点（PackedVertex / QuantizedVertex）の法線で陰影を付ける
+//   QUANTIZED_POSITION : 量子化位置を uPosScale / uPosBias で復元する
+//   DYNAMIC            : 上 2 つを uniform で切り替える汎用版（専用バリアントが出来るまでの代用）
+#ifdef DYNAMIC
+#define PACKED_VERTEX 1
+#define QUANTIZED_POSITION 1
+#endif
+
 #ifdef VERTEX
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec4 aColor;
 
-uniform mat4 uMVP;
+#ifdef INSTANCED
+// インスタンス属性（InstanceBuffer）。モデル行列はここから取る
+layout (location = 2) in mat4 aModel;
+layout (location = 6) in vec4 aInstanceColor;
+#endif
+
+// フレームごとのカメラ（FrameUniforms と同じ並び）
+layout(std140) uniform Frame
+{
+	mat4 uView;
+	mat4 uProj;
+	mat4 uViewProj;
+	mat4 uInvViewProj;
+	vec4 uViewport;		// x, y, 幅, 高さ
+	vec4 uTime;			// 経過秒, 前フレームからの秒, フレーム番号, 0
+};
+
+#ifdef QUANTIZED_POSITION
+// 量子化位置の復元（[0, 1] → メッシュの AABB）。DYNAMIC で Full / Packed を描くときは恒等
+uniform vec3 uPosScale = vec3(1.0);
+uniform vec3 uPosBias = vec3(0.0);
+#endif
+
+#ifdef PACKED_VERTEX
+// 無効な属性は (0, 0) = +Z になる
+layout (location = 8) in vec2 aNormalOct;
+
+#ifdef DYNAMIC
+// 1 なら法線で陰影を付ける（法線を持つ圧縮メッシュの面だけ）
+uniform float uShade = 0.0;
+#else
+const float uShade = 1.0;
+#endif
+
+// vertex_pack::unpackNormal と同じ式
+vec3 decodeOctahedral(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	return normalize(n);
+}
+#endif
+
 out vec4 vColor;
 
 void main()
 {
-	vColor = aColor; gl_Position = uMVP * vec4(aPos,1.0);
+#ifdef QUANTIZED_POSITION
+	vec3 pos = aPos * uPosScale + uPosBias;
+#else
+	vec3 pos = aPos;
+#endif
+
+#ifdef INSTANCED
+	vColor = aColor * aInstanceColor; gl_Position = uViewProj * aModel * vec4(pos,1.0);
+#else
+	vColor = aColor; gl_Position = uViewProj * vec4(pos,1.0);
+#endif
+
+#ifdef PACKED_VERTEX
+	vec3 normal = decodeOctahedral(aNormalOct);
+#ifdef INSTANCED
+	normal = mat3(aModel) * normal;
+#endif
+
+	// 両面の平行光（向きは固定）
+	float lambert = abs(dot(normalize(normal), normalize(vec3(0.4, 1.0, 0.6))));
+	vColor.rgb *= mix(1.0, 0.35 + 0.65 * lambert, uShade);
+#endif
 }
 #endif
 
@@ -21,4 +95,4 @@ void main()
 {
 	FragColor=vColor;
 }
-#endif
\ No newline at end of file
+#endif
@@ -3,21 +3,52 @@
 #ifdef VERTEX
 layout(location=0) in vec3 aPos;
 
-uniform mat4 uMVP;
+#ifdef INSTANCED
+// インスタンス属性（InstanceBuffer）。モデル行列はここから取る
+layout(location=2) in mat4 aModel;
+layout(location=7) in uint aInstanceID;
+#else
+// 面 ID + 1（FaceMesh の頂点属性。面の頂点はすべて同じ値）
+layout(location=10) in uint aFaceID;
+#endif
+flat out uint vID;
+
+// フレームごとのカメラ（FrameUniforms と同じ並び）。
+// uViewProj には Picker がパスの行列（ピック行列込み。面のパスは編集メッシュの MVP）を入れる
+layout(std140) uniform Frame
+{
+	mat4 uView;
+	mat4 uProj;
+	mat4 uViewProj;
+	mat4 uInvViewProj;
+	vec4 uViewport;		// x, y, 幅, 高さ
+	vec4 uTime;			// 経過秒, 前フレームからの秒, フレーム番号, 0
+};
+
+// 量子化位置の復元（line.glsl と同じ。Full / Packed では恒等）
+uniform vec3 uPosScale = vec3(1.0);
+uniform vec3 uPosBias = vec3(0.0);
 
 void main()
 {
-	gl_Position = uMVP * vec4(aPos, 1.0);
+	vec3 pos = aPos * uPosScale + uPosBias;
+#ifdef INSTANCED
+	vID = aInstanceID;
+	gl_Position = uViewProj * aModel * vec4(pos, 1.0);
+#else
+	vID = aFaceID;
+	gl_Position = uViewProj * vec4(pos, 1.0);
+#endif
 }
 #endif
 
 #ifdef FRAGMENT
-uniform uint uID;
+flat in uint vID;
 
 layout(location=0) out uint outID;
 
 void main()
 {
-	outID = uID;
+	outID = vID;
 }
 #endif
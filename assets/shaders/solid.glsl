@@ -3,11 +3,29 @@
 #ifdef VERTEX
 layout(location=0) in vec3 aPos;
 
-uniform mat4 uMVP;
+#ifdef INSTANCED
+// インスタンス属性（InstanceBuffer）。モデル行列はここから取る
+layout(location=2) in mat4 aModel;
+#endif
+
+// フレームごとのカメラ（FrameUniforms と同じ並び）
+layout(std140) uniform Frame
+{
+	mat4 uView;
+	mat4 uProj;
+	mat4 uViewProj;
+	mat4 uInvViewProj;
+	vec4 uViewport;		// x, y, 幅, 高さ
+	vec4 uTime;			// 経過秒, 前フレームからの秒, フレーム番号, 0
+};
 
 void main()
 {
-	gl_Position = uMVP * vec4(aPos, 1.0);
+#ifdef INSTANCED
+	gl_Position = uViewProj * aModel * vec4(aPos, 1.0);
+#else
+	gl_Position = uViewProj * vec4(aPos, 1.0);
+#endif
 }
 #endif
 
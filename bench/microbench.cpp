@@ -0,0 +1,481 @@
+// CPU 側カーネルのマイクロベンチマーク（GL 不要）
+//
+// usage: aquamarine_microbench [--filter substr] [--reps N] [--warmup-ms MS] [--sample-ms MS]
+//                              [--scale N] [--threads N] [--json path] [--list]
+//
+//   --filter    名前に substr を含むケースだけ実行
+//   --reps      計測サンプル数（既定 15）。統計はサンプルごとの ns/op から出す
+//   --scale     入力サイズの倍率（既定 1）
+//   --threads   並列化されたカーネル（OBJ 解析・カリング）のスレッド数。既定 1（0 でハードウェア並列数）
+//
+// 各ケースはウォームアップの後、1 サンプルが --sample-ms 以上になる反復回数を決めて --reps 回測る。
+// 結果は ns/op（min / median / mean / p90 / stddev）、1 op あたりのヒープ確保回数・バイト数、
+// スループット（要素/s、入力バイトがあるものは MB/s）。
+// JSON（既定 microbench_result.json）に同じ内容を書き出すので、実行同士を比較できる。
+//
+// 新しいカーネルは registerCases() に addCase() を 1 つ足せばよい。入力の準備はラムダの外で済ませること。
+
+#include "algorithm"
+#include "atomic"
+#include "chrono"
+#include "cmath"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "functional"
+#include "memory"
+#include "new"
+#include "random"
+#include "stdexcept"
+#include "string"
+#include "vector"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "io/obj_importer.h"
+#include "mesh/bvh.h"
+#include "mesh/edit_mesh.h"
+#include "profile/rolling_stats.h"
+#include "render/dirty_ranges.h"
+#include "render/geometry_gen.h"
+#include "render/mesh_builder.h"
+#include "render/range_allocator.h"
+#include "render/sort_key.h"
+#include "render/vertex_pack.h"
+#include "scene/frustum_culler.h"
+#include "scene/scene.h"
+
+// ===== ヒープ確保の計測 =====
+// グローバルの operator new を置き換えて回数とバイト数を数える（このベンチマークの実行ファイルだけ）
+
+namespace
+{
+    std::atomic<uint64_t> g_allocCount{ 0 };
+    std::atomic<uint64_t> g_allocBytes{ 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Options
+    {
+        std::string filter;
+        int reps = 15;
+        double warmupMs = 100.0;
+        double sampleMs = 20.0;
+        int scale = 1;
+        unsigned threads = 1;
+        bool list = false;
+        std::string json = "microbench_result.json";
+    };
+
+    Options parseArgs(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (!std::strcmp(argv[i], "--filter") && hasValue) o.filter = argv[++i];
+            else if (!std::strcmp(argv[i], "--reps") && hasValue) o.reps = std::max(1, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--warmup-ms") && hasValue) o.warmupMs = std::max(0.0, std::atof(argv[++i]));
+            else if (!std::strcmp(argv[i], "--sample-ms") && hasValue) o.sampleMs = std::max(0.1, std::atof(argv[++i]));
+            else if (!std::strcmp(argv[i], "--scale") && hasValue) o.scale = std::max(1, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--threads") && hasValue) o.threads = (unsigned)std::max(0, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--json") && hasValue) o.json = argv[++i];
+            else if (!std::strcmp(argv[i], "--list")) o.list = true;
+            else throw std::runtime_error(std::string("Unknown argument: ") + argv[i]);
+        }
+        return o;
+    }
+
+    // 結果を捨てられないように触っておく
+    volatile size_t g_sink = 0;
+
+    struct Case
+    {
+        std::string name;
+        const char* unit;       ///< items の単位（verts / tris / keys など）
+        double items;           ///< 1 op あたりの処理要素数
+        double bytes;           ///< 1 op あたりの入力バイト数（0 なら MB/s は出さない）
+        std::function<void()> run;
+    };
+
+    struct Result
+    {
+        const Case* c = nullptr;
+        uint64_t itersPerSample = 0;
+        double minNs = 0.0, medianNs = 0.0, meanNs = 0.0, p90Ns = 0.0, stddevNs = 0.0;
+        double allocsPerOp = 0.0, allocBytesPerOp = 0.0;
+        double itemsPerSec = 0.0, mbPerSec = 0.0;
+    };
+
+    std::vector<Case> g_cases;
+
+    void addCase(std::string name, const char* unit, double items, double bytes, std::function<void()> run)
+    {
+        g_cases.push_back({ std::move(name), unit, items, bytes, std::move(run) });
+    }
+
+    double elapsedNs(Clock::time_point t0, Clock::time_point t1)
+    {
+        return std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+
+    Result measure(const Case& c, const Options& opt)
+    {
+        // ウォームアップ（1 回以上）。ついでに 1 op の時間を見積もる
+        uint64_t warmIters = 0;
+        const Clock::time_point w0 = Clock::now();
+        Clock::time_point w1 = w0;
+        do
+        {
+            c.run();
+            ++warmIters;
+            w1 = Clock::now();
+        } while (elapsedNs(w0, w1) < opt.warmupMs * 1e6);
+
+        const double estimateNs = std::max(elapsedNs(w0, w1) / (double)warmIters, 1.0);
+        const uint64_t iters = std::max<uint64_t>(1, (uint64_t)(opt.sampleMs * 1e6 / estimateNs));
+
+        RollingStats stats((size_t)opt.reps);
+        double sum = 0.0, sumSq = 0.0;
+        uint64_t allocs = 0, allocBytes = 0;
+        for (int r = 0; r < opt.reps; ++r)
+        {
+            const uint64_t a0 = g_allocCount.load(std::memory_order_relaxed);
+            const uint64_t b0 = g_allocBytes.load(std::memory_order_relaxed);
+            const Clock::time_point t0 = Clock::now();
+            for (uint64_t i = 0; i < iters; ++i)
+                c.run();
+            const Clock::time_point t1 = Clock::now();
+            allocs += g_allocCount.load(std::memory_order_relaxed) - a0;
+            allocBytes += g_allocBytes.load(std::memory_order_relaxed) - b0;
+
+            const double ns = elapsedNs(t0, t1) / (double)iters;
+            stats.push(ns);
+            sum += ns;
+            sumSq += ns * ns;
+        }
+
+        const double n = (double)opt.reps;
+        const double totalOps = n * (double)iters;
+
+        Result res;
+        res.c = &c;
+        res.itersPerSample = iters;
+        res.minNs = stats.min();
+        res.medianNs = stats.percentile(50.0);
+        res.meanNs = sum / n;
+        res.p90Ns = stats.percentile(90.0);
+        res.stddevNs = std::sqrt(std::max(0.0, sumSq / n - res.meanNs * res.meanNs));
+        res.allocsPerOp = (double)allocs / totalOps;
+        res.allocBytesPerOp = (double)allocBytes / totalOps;
+        res.itemsPerSec = c.items * 1e9 / res.medianNs;
+        res.mbPerSec = c.bytes > 0.0 ? c.bytes * 1e3 / res.medianNs : 0.0;
+        return res;
+    }
+
+    // ===== 入力データ =====
+
+    // g×g の四角形。高さに起伏を付ける（BVH の分割が平面だけに偏らないように）
+    EditMesh createTerrain(int g)
+    {
+        const int n = g + 1;
+        std::vector<glm::vec3> positions;
+        positions.reserve((size_t)n * n);
+        for (int z = 0; z < n; ++z)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                const float u = (float)x / (float)g - 0.5f;
+                const float v = (float)z / (float)g - 0.5f;
+                positions.emplace_back(u, 0.05f * std::sin(u * 17.0f) * std::cos(v * 13.0f), v);
+            }
+        }
+
+        std::vector<uint32_t> sizes((size_t)g * g, 4u);
+        std::vector<uint32_t> indices;
+        indices.reserve(sizes.size() * 4);
+        for (int z = 0; z < g; ++z)
+        {
+            for (int x = 0; x < g; ++x)
+            {
+                const uint32_t a = (uint32_t)(z * n + x);
+                indices.insert(indices.end(), { a, a + (uint32_t)n, a + (uint32_t)n + 1, a + 1 });
+            }
+        }
+        return EditMesh::fromPolygons(positions, sizes, indices);
+    }
+
+    // aquamarine_obj_bench と同じ形（v/vt/vn 付きの四角形格子）をメモリ上に作る
+    std::string syntheticObj(int grid)
+    {
+        std::string text;
+        char line[128];
+        const int n = grid + 1;
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x)
+                text.append(line, (size_t)std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n",
+                    x / (float)grid, 0.01f * ((x * 7 + y * 13) % 17), y / (float)grid));
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x)
+                text.append(line, (size_t)std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", x / (float)grid, y / (float)grid));
+        text += "vn 0 1 0\n";
+
+        for (int y = 0; y < grid; ++y)
+        {
+            for (int x = 0; x < grid; ++x)
+            {
+                const int a = y * n + x + 1, b = a + 1, c = a + n + 1, d = a + n;
+                text.append(line, (size_t)std::snprintf(line, sizeof(line),
+                    "f %d/%d/1 %d/%d/1 %d/%d/1 %d/%d/1\n", a, a, d, d, c, c, b, b));
+            }
+        }
+        return text;
+    }
+
+    // ===== ケース =====
+
+    void registerCases(const Options& opt)
+    {
+        const int s = opt.scale;
+        const unsigned threads = opt.threads;
+
+        // --- geometry_gen ---
+        {
+            addCase("geometry_gen/cube", "faces", 6.0, 0.0,
+                [] { g_sink = g_sink + geometry_gen::createCube().faceCount(); });
+        }
+
+        // --- EditMesh / mesh_builder / BVH（共通の格子メッシュ）---
+        const int g = 256 * s;
+        auto mesh = std::make_shared<const EditMesh>(createTerrain(g));
+        const double faces = (double)mesh->faceCount();
+        const double tris = faces * 2.0;
+
+        {
+            auto positions = std::make_shared<std::vector<glm::vec3>>(mesh->positions());
+            auto sizes = std::make_shared<std::vector<uint32_t>>((size_t)mesh->faceCount(), 4u);
+            auto indices = std::make_shared<std::vector<uint32_t>>(mesh->halfEdgeVertex());
+            addCase("edit_mesh/from_polygons", "faces", faces, 0.0,
+                [positions, sizes, indices] { g_sink = g_sink + EditMesh::fromPolygons(*positions, *sizes, *indices).edgeCount(); });
+
+            // キャッシュから読むとき（保存した twin を検査して使う。ソートしない）
+            auto twins = std::make_shared<std::vector<uint32_t>>(mesh->halfEdgeTwin());
+            const uint32_t edges = mesh->edgeCount();
+            addCase("edit_mesh/from_polygons_twins", "faces", faces, 0.0,
+                [positions, sizes, indices, twins, edges]
+                { g_sink = g_sink + EditMesh::fromPolygons(*positions, *sizes, *indices, *twins, edges).edgeCount(); });
+        }
+        {
+            auto normals = std::make_shared<std::vector<glm::vec3>>(mesh->faceCount());
+            addCase("edit_mesh/face_normals", "faces", faces, 0.0,
+                [mesh, normals]
+                {
+                    for (uint32_t f = 0; f < mesh->faceCount(); ++f)
+                        (*normals)[f] = mesh->faceNormal(f);
+                    g_sink = g_sink + (size_t)(*normals)[0].y;
+                });
+        }
+        {
+            auto verts = std::make_shared<std::vector<Vertex>>();
+            auto indices = std::make_shared<std::vector<uint32_t>>();
+            addCase("mesh_builder/triangles", "tris", tris, 0.0,
+                [mesh, verts, indices]
+                {
+                    mesh_builder::buildTriangles(*mesh, glm::vec4(1.0f), *verts, *indices);
+                    g_sink = g_sink + indices->size();
+                });
+        }
+        addCase("mesh_builder/edge_lines", "edges", (double)mesh->edgeCount(), 0.0,
+            [mesh] { g_sink = g_sink + mesh_builder::buildEdgeLines(*mesh, glm::vec4(1.0f)).size(); });
+        addCase("mesh_builder/face_triangles", "tris", tris, 0.0,
+            [mesh] { g_sink = g_sink + mesh_builder::buildFaceTriangles(*mesh).positions.size(); });
+        addCase("bvh/build", "tris", tris, 0.0,
+            [mesh]
+            {
+                TriangleBvh bvh;
+                bvh.build(*mesh);
+                g_sink = g_sink + bvh.nodeCount();
+            });
+
+        // --- vertex_pack ---
+        {
+            auto verts = std::make_shared<std::vector<Vertex>>();
+            auto indices = std::make_shared<std::vector<uint32_t>>();
+            mesh_builder::buildTriangles(*mesh, glm::vec4(0.8f, 0.6f, 0.4f, 1.0f), *verts, *indices);
+            auto normals = std::make_shared<std::vector<glm::vec3>>(verts->size(), glm::vec3(0.0f, 1.0f, 0.0f));
+            auto packed = std::make_shared<std::vector<PackedVertex>>();
+            auto quantized = std::make_shared<std::vector<QuantizedVertex>>();
+            const double bytes = (double)(verts->size() * sizeof(Vertex));
+            addCase("vertex_pack/pack", "verts", (double)verts->size(), bytes,
+                [verts, normals, packed]
+                {
+                    vertex_pack::pack(*verts, *normals, {}, *packed);
+                    g_sink = g_sink + packed->size();
+                });
+            addCase("vertex_pack/quantize", "verts", (double)verts->size(), bytes,
+                [verts, normals, quantized]
+                {
+                    vertex_pack::quantize(*verts, *normals, {}, *quantized);
+                    g_sink = g_sink + quantized->size();
+                });
+        }
+
+        // --- obj_importer ---
+        {
+            auto text = std::make_shared<const std::string>(syntheticObj(200 * s));
+            addCase("obj_importer/parse", "bytes", (double)text->size(), (double)text->size(),
+                [text, threads] { g_sink = g_sink + obj_importer::parse(*text, threads).indices.size(); });
+        }
+
+        // --- sort_key（毎回同じ入力を作業配列へコピーしてからソート。コピーも含む）---
+        {
+            const size_t count = 100000 * (size_t)s;
+            auto input = std::make_shared<std::vector<sort_key::Entry>>(count);
+            std::mt19937 rng(1234);
+            std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+            for (size_t i = 0; i < count; ++i)
+                (*input)[i] = { sort_key::opaque(rng() % 2, rng() % 8, rng() % 4, depth(rng)), (uint32_t)i };
+            auto work = std::make_shared<std::vector<sort_key::Entry>>(count);
+            auto scratch = std::make_shared<std::vector<sort_key::Entry>>(count);
+            addCase("sort_key/radix_sort", "keys", (double)count, 0.0,
+                [input, work, scratch]
+                {
+                    std::copy(input->begin(), input->end(), work->begin());
+                    sort_key::radixSort(*work, *scratch);
+                    g_sink = g_sink + (*work)[0].index;
+                });
+        }
+
+        // --- RangeAllocator / DirtyRanges ---
+        {
+            const uint32_t ops = 4096;
+            addCase("range_allocator/churn", "ops", (double)ops * 2.0, 0.0,
+                [ops]
+                {
+                    // 確保を並べてから 1 つおきに解放し、残りを解放して結合させる
+                    RangeAllocator alloc(ops * 64);
+                    std::vector<uint32_t> offsets(ops);
+                    for (uint32_t i = 0; i < ops; ++i) offsets[i] = alloc.allocate(1 + i % 61);
+                    for (uint32_t i = 0; i < ops; i += 2) alloc.release(offsets[i], 1 + i % 61);
+                    for (uint32_t i = 1; i < ops; i += 2) alloc.release(offsets[i], 1 + i % 61);
+                    g_sink = g_sink + alloc.freeBlockCount();
+                });
+
+            auto edits = std::make_shared<std::vector<uint32_t>>(4096);
+            std::mt19937 rng(42);
+            for (uint32_t& e : *edits) e = rng() % 1000000u;
+            addCase("dirty_ranges/add", "ranges", (double)edits->size(), 0.0,
+                [edits]
+                {
+                    DirtyRanges ranges;
+                    for (uint32_t e : *edits) ranges.add(e, 4);
+                    g_sink = g_sink + ranges.dirtyCount();
+                });
+        }
+
+        // --- frustum_cull ---
+        {
+            const int n = 320 * s;
+            auto scene = std::make_shared<Scene>();
+            scene->reserve((size_t)n * n);
+            for (int i = 0; i < n * n; ++i)
+            {
+                const uint32_t node = scene->addNode();
+                scene->setTranslation(node, glm::vec3((float)(i % n) - 0.5f * n, 0.0f, (float)(i / n) - 0.5f * n));
+                scene->setLocalBounds(node, glm::vec3(-0.4f), glm::vec3(0.4f));
+            }
+            scene->updateWorld();
+            auto bounds = std::make_shared<Scene::BoundsSoA>(scene->worldBounds());
+            auto visible = std::make_shared<std::vector<uint8_t>>(bounds->size());
+            // 格子の端から中心を見下ろす（半分強が視錐台の外）
+            const glm::mat4 vp = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f)
+                * glm::lookAt(glm::vec3(0.0f, 0.1f * n, 0.5f * n), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            addCase("frustum_cull/cull", "nodes", (double)bounds->size(), 0.0,
+                [scene, bounds, visible, vp, threads]
+                {
+                    g_sink = g_sink + frustum_cull::cull(Frustum::fromViewProj(vp), *bounds, *visible, threads);
+                });
+        }
+    }
+
+    void writeJson(const std::string& path, const Options& opt, const std::vector<Result>& results)
+    {
+        FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) throw std::runtime_error("Failed to write " + path);
+
+        std::fprintf(f, "{\n");
+        std::fprintf(f, "  \"config\": { \"reps\": %d, \"warmup_ms\": %.1f, \"sample_ms\": %.1f, \"scale\": %d, \"threads\": %u },\n",
+            opt.reps, opt.warmupMs, opt.sampleMs, opt.scale, opt.threads);
+        std::fprintf(f, "  \"results\": [\n");
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::fprintf(f,
+                "    { \"name\": \"%s\", \"unit\": \"%s\", \"items_per_op\": %.0f, \"iters_per_sample\": %llu, "
+                "\"ns_per_op\": { \"min\": %.1f, \"median\": %.1f, \"mean\": %.1f, \"p90\": %.1f, \"stddev\": %.1f }, "
+                "\"allocs_per_op\": %.3f, \"alloc_bytes_per_op\": %.1f, \"items_per_sec\": %.1f, \"mb_per_sec\": %.2f }%s\n",
+                r.c->name.c_str(), r.c->unit, r.c->items, (unsigned long long)r.itersPerSample,
+                r.minNs, r.medianNs, r.meanNs, r.p90Ns, r.stddevNs,
+                r.allocsPerOp, r.allocBytesPerOp, r.itemsPerSec, r.mbPerSec,
+                i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        std::fclose(f);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const Options opt = parseArgs(argc, argv);
+        registerCases(opt);
+
+        if (opt.list)
+        {
+            for (const Case& c : g_cases) std::printf("%s\n", c.name.c_str());
+            return 0;
+        }
+
+        std::printf("%-30s %14s %14s %10s %12s %14s %10s\n",
+            "case", "median ns/op", "min ns/op", "stddev%", "allocs/op", "items/s", "MB/s");
+
+        std::vector<Result> results;
+        for (const Case& c : g_cases)
+        {
+            if (!opt.filter.empty() && c.name.find(opt.filter) == std::string::npos) continue;
+
+            const Result r = measure(c, opt);
+            results.push_back(r);
+            char mb[32] = "-";
+            if (c.bytes > 0.0) std::snprintf(mb, sizeof(mb), "%.1f", r.mbPerSec);
+            std::printf("%-30s %14.0f %14.0f %9.1f%% %12.2f %14.3g %10s\n",
+                c.name.c_str(), r.medianNs, r.minNs, 100.0 * r.stddevNs / r.meanNs,
+                r.allocsPerOp, r.itemsPerSec, mb);
+        }
+
+        writeJson(opt.json, opt, results);
+        std::printf("wrote %s\n", opt.json.c_str());
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Fatal: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+// OBJ インポートのスループット計測
+//
+// usage: aquamarine_obj_bench [file.obj] [--threads N] [--runs N] [--grid N]
+//   file.obj を省略すると grid x grid の四角形メッシュ（v/vt/vn 付き）を一時ファイルに書き出して使う
+
+#include "algorithm"
+#include "chrono"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "filesystem"
+#include "stdexcept"
+#include "string"
+#include "vector"
+
+#include "io/mapped_file.h"
+#include "io/obj_importer.h"
+
+namespace
+{
+    std::string writeSyntheticObj(int grid)
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "aquamarine_bench_grid.obj";
+
+        FILE* f = std::fopen(path.string().c_str(), "wb");
+        if (!f) throw std::runtime_error("Failed to create " + path.string());
+
+        std::vector<char> buf(1 << 20);
+        std::setvbuf(f, buf.data(), _IOFBF, buf.size());
+
+        const int n = grid + 1;
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x)
+                std::fprintf(f, "v %.6f %.6f %.6f\n", x / (float)grid, 0.01f * ((x * 7 + y * 13) % 17), y / (float)grid);
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x)
+                std::fprintf(f, "vt %.6f %.6f\n", x / (float)grid, y / (float)grid);
+        std::fprintf(f, "vn 0 1 0\n");
+
+        for (int y = 0; y < grid; ++y)
+        {
+            for (int x = 0; x < grid; ++x)
+            {
+                const int a = y * n + x + 1, b = a + 1, c = a + n + 1, d = a + n;
+                std::fprintf(f, "f %d/%d/1 %d/%d/1 %d/%d/1 %d/%d/1\n", a, a, d, d, c, c, b, b);
+            }
+        }
+
+        std::fclose(f);
+        return path.string();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string path;
+    unsigned threads = 0;
+    int runs = 5;
+    int grid = 1000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = (unsigned)std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--grid") && i + 1 < argc) grid = std::max(1, std::atoi(argv[++i]));
+        else path = argv[i];
+    }
+
+    try
+    {
+        if (path.empty())
+            path = writeSyntheticObj(grid);
+
+        const size_t bytes = MappedFile(path.c_str()).size();
+        std::printf("file: %s (%.1f MB)\n", path.c_str(), bytes / 1e6);
+
+        std::vector<double> seconds;
+        for (int r = 0; r < runs; ++r)
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            ObjMeshData obj = obj_importer::load(path.c_str(), threads);
+            const auto t1 = std::chrono::steady_clock::now();
+
+            const double s = std::chrono::duration<double>(t1 - t0).count();
+            seconds.push_back(s);
+            std::printf("run %d: %.3f s  %.1f MB/s  (%zu verts, %zu tris)\n",
+                r, s, bytes / 1e6 / s, obj.vertices.size(), obj.indices.size() / 3);
+        }
+
+        std::sort(seconds.begin(), seconds.end());
+        const double median = seconds[seconds.size() / 2];
+        std::printf("median: %.3f s  %.1f MB/s\n", median, bytes / 1e6 / median);
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Fatal: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
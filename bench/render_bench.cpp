@@ -0,0 +1,314 @@
+// 描画 + ピッキングのフレーム時間計測（非表示ウィンドウ、vsync 無し）
+//
+// usage: aquamarine_bench [--frames N] [--warmup N] [--objects N] [--triangles N]
+//                         [--picks N] [--pick-target faces|objects] [--pick-mode gpu|cpu]
+//                         [--width W] [--height H] [--no-cull] [--finish] [--json path]
+//
+//   --objects   インスタンス描画する立方体の数（正方格子に並べる）
+//   --triangles 編集メッシュ（起伏のある格子）の三角形数の目安
+//   --picks     1 フレームあたりのピック回数（画面上をリサジュー曲線で動かす）
+//   --finish    毎フレーム glFinish して GPU の完了まで含めて測る
+//
+// カメラは原点の周りを一定速度で 1 周する（フレーム数で割るので結果はフレーム数によらず同じ経路）。
+// GPU の無い Linux では Mesa llvmpipe で動く:
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./aquamarine_bench
+// アセット（assets/shaders）は実行ファイルの隣にコピーされるので、ビルドディレクトリで実行すること。
+
+#include "algorithm"
+#include "chrono"
+#include "cmath"
+#include "cstdio"
+#include "cstdlib"
+#include "cstring"
+#include "stdexcept"
+#include "string"
+#include "vector"
+
+#include "glad/glad.h"
+#include "GLFW/glfw3.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "mesh/edit_mesh.h"
+#include "platform/platform.h"
+#include "render/frame_uniforms.h"
+#include "render/gl_state.h"
+#include "render/picker.h"
+#include "render/renderer.h"
+#include "scene/frustum_culler.h"
+#include "scene/scene.h"
+#include "select/face_selection.h"
+
+namespace
+{
+    struct Options
+    {
+        int frames = 600;
+        int warmup = 60;
+        int objects = 10000;
+        int triangles = 20000;
+        int picks = 1;
+        int width = 1280;
+        int height = 720;
+        bool pickObjects = false;
+        bool pickCpu = false;
+        bool cull = true;
+        bool finish = false;
+        std::string json = "bench_result.json";
+    };
+
+    Options parseArgs(int argc, char** argv)
+    {
+        Options o;
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (!std::strcmp(argv[i], "--frames") && hasValue) o.frames = std::max(1, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--warmup") && hasValue) o.warmup = std::max(0, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--objects") && hasValue) o.objects = std::max(0, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--triangles") && hasValue) o.triangles = std::max(2, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--picks") && hasValue) o.picks = std::max(0, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--width") && hasValue) o.width = std::max(16, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--height") && hasValue) o.height = std::max(16, std::atoi(argv[++i]));
+            else if (!std::strcmp(argv[i], "--pick-target") && hasValue) o.pickObjects = !std::strcmp(argv[++i], "objects");
+            else if (!std::strcmp(argv[i], "--pick-mode") && hasValue) o.pickCpu = !std::strcmp(argv[++i], "cpu");
+            else if (!std::strcmp(argv[i], "--json") && hasValue) o.json = argv[++i];
+            else if (!std::strcmp(argv[i], "--no-cull")) o.cull = false;
+            else if (!std::strcmp(argv[i], "--finish")) o.finish = true;
+            else throw std::runtime_error(std::string("Unknown argument: ") + argv[i]);
+        }
+        return o;
+    }
+
+    // g×g の四角形（三角形 2g² 個）。高さに起伏を付けて面の向きをばらけさせる
+    EditMesh createTerrain(int triangles, float size)
+    {
+        const int g = std::max(1, (int)std::lround(std::sqrt(triangles * 0.5)));
+        const int n = g + 1;
+
+        std::vector<glm::vec3> positions;
+        positions.reserve((size_t)n * n);
+        for (int z = 0; z < n; ++z)
+        {
+            for (int x = 0; x < n; ++x)
+            {
+                const float u = (float)x / (float)g - 0.5f;
+                const float v = (float)z / (float)g - 0.5f;
+                const float h = 0.05f * size * std::sin(u * 17.0f) * std::cos(v * 13.0f);
+                positions.emplace_back(u * size, h, v * size);
+            }
+        }
+
+        std::vector<uint32_t> sizes((size_t)g * g, 4u);
+        std::vector<uint32_t> indices;
+        indices.reserve(sizes.size() * 4);
+        for (int z = 0; z < g; ++z)
+        {
+            for (int x = 0; x < g; ++x)
+            {
+                const uint32_t a = (uint32_t)(z * n + x);
+                indices.insert(indices.end(), { a, a + (uint32_t)n, a + (uint32_t)n + 1, a + 1 });
+            }
+        }
+        return EditMesh::fromPolygons(positions, sizes, indices);
+    }
+
+    void buildScene(Scene& scene, int objects, float terrainSize)
+    {
+        scene.clear();
+
+        const uint32_t edit = scene.addNode(Scene::kNoParent, Renderer::kEditMesh);
+        scene.setLocalBounds(edit, glm::vec3(-0.5f * terrainSize, -terrainSize, -0.5f * terrainSize),
+            glm::vec3(0.5f * terrainSize, terrainSize, 0.5f * terrainSize));
+
+        if (objects <= 0) return;
+
+        const int n = (int)std::ceil(std::sqrt((double)objects));
+        const float spacing = 1.5f;
+        const float origin = -0.5f * spacing * (float)(n - 1);
+        scene.reserve(1 + (size_t)objects);
+        for (int i = 0; i < objects; ++i)
+        {
+            const int x = i % n, z = i / n;
+            const uint32_t node = scene.addNode(Scene::kNoParent, Renderer::kPartMesh);
+            scene.setTranslation(node, glm::vec3(origin + spacing * x, 1.0f, origin + spacing * z));
+            scene.setScale(node, glm::vec3(0.5f));
+            scene.setLocalBounds(node, glm::vec3(-0.5f), glm::vec3(0.5f));
+            scene.setColor(node, glm::vec4(0.3f + 0.7f * x / n, 0.5f, 0.3f + 0.7f * z / n, 1.0f));
+        }
+    }
+
+    double percentile(std::vector<double> sorted, double p)
+    {
+        if (sorted.empty()) return 0.0;
+        std::sort(sorted.begin(), sorted.end());
+        const size_t k = (size_t)std::max(std::ceil(p / 100.0 * (double)sorted.size()), 1.0) - 1;
+        return sorted[std::min(k, sorted.size() - 1)];
+    }
+
+    std::string jsonEscape(const char* s)
+    {
+        std::string out;
+        for (; s && *s; ++s)
+        {
+            if (*s == '"' || *s == '\\') out.push_back('\\');
+            if ((unsigned char)*s < 0x20) continue;
+            out.push_back(*s);
+        }
+        return out;
+    }
+
+    const char* glString(GLenum name)
+    {
+        const GLubyte* s = glGetString(name);
+        return s ? (const char*)s : "";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const Options opt = parseArgs(argc, argv);
+
+        PlatformOptions platformOptions;
+        platformOptions.width = opt.width;
+        platformOptions.height = opt.height;
+        platformOptions.title = "aquamarine_bench";
+        platformOptions.visible = false;
+        platformOptions.vsync = false;
+        Platform platform(platformOptions);
+
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+            throw std::runtime_error("Failed to initialize glad");
+
+        gl_state::enable(GL_DEPTH_TEST);
+        gl_state::depthFunc(GL_LESS);
+
+        const float terrainSize = 8.0f;
+        const EditMesh mesh = createTerrain(opt.triangles, terrainSize);
+
+        Scene scene;
+        buildScene(scene, opt.objects, terrainSize);
+
+        Renderer renderer;
+        renderer.init(mesh);
+
+        Picker picker;
+        picker.init(platform.window(), &renderer);
+        picker.setMesh(mesh);
+        picker.setMode(opt.pickCpu ? PickMode::CpuBvh : PickMode::GpuIdBuffer);
+        picker.setTarget(opt.pickObjects ? PickTarget::Objects : PickTarget::Faces);
+
+        int fbW = 0, fbH = 0;
+        platform.framebufferSize(fbW, fbH);
+
+        std::printf("renderer: %s\n", glString(GL_RENDERER));
+        std::printf("scene: %d objects, %u faces (%d frames + %d warmup, %dx%d)\n",
+            opt.objects, mesh.faceCount(), opt.frames, opt.warmup, fbW, fbH);
+
+        const FaceSelection selection;
+        std::vector<uint8_t> visibility;
+        std::vector<double> frameMillis, pickMicros;
+        frameMillis.reserve(opt.frames);
+        pickMicros.reserve((size_t)opt.frames * opt.picks);
+        uint32_t pickHits = 0;
+
+        const float extent = std::max(terrainSize, 1.5f * (float)std::ceil(std::sqrt((double)opt.objects)));
+        const glm::mat4 proj = glm::perspectiveRH(60.0f * 3.1415926f / 180.0f, (float)fbW / (float)fbH, 0.1f, 10.0f * extent);
+
+        const int total = opt.warmup + opt.frames;
+        for (int frame = 0; frame < total; ++frame)
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            glfwPollEvents();
+            gl_state::beginFrame();
+
+            // 原点の周りを 1 周しながら少し上下する
+            const float t = (float)frame / (float)total;
+            const float angle = t * 2.0f * 3.1415926f;
+            const glm::vec3 eye(std::cos(angle) * 0.7f * extent, (0.3f + 0.1f * std::sin(angle * 3.0f)) * extent,
+                std::sin(angle) * 0.7f * extent);
+            const glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            const glm::mat4 vp = proj * view;
+
+            // 時間も台本どおり（60 Hz 換算）にして、実行ごとに同じ値を書く
+            renderer.beginFrame(FrameUniforms::make(view, proj, fbW, fbH,
+                (float)frame / 60.0f, 1.0f / 60.0f, (uint32_t)frame));
+            renderer.setGrid(true, glm::length(eye));
+
+            scene.updateWorld();
+            if (opt.cull)
+            {
+                visibility.resize(scene.nodeCount());
+                frustum_cull::cull(Frustum::fromViewProj(vp), scene.worldBounds(), visibility);
+            }
+
+            // 面は編集メッシュのローカル空間（ここでは単位行列なので VP のまま）
+            for (int p = 0; p < opt.picks; ++p)
+            {
+                const double s = (double)(frame * opt.picks + p);
+                const double x = (0.5 + 0.4 * std::sin(s * 0.031)) * fbW;
+                const double y = (0.5 + 0.4 * std::sin(s * 0.047 + 1.0)) * fbH;
+                if (picker.pickAt(vp, fbW, fbH, x, y) != 0) ++pickHits;
+                if (frame >= opt.warmup) pickMicros.push_back(picker.lastPickMicros());
+            }
+
+            renderer.draw(scene, selection, 0,
+                opt.cull ? std::span<const uint8_t>(visibility) : std::span<const uint8_t>());
+            glfwSwapBuffers(platform.window());
+            if (opt.finish) glFinish();
+
+            const auto t1 = std::chrono::steady_clock::now();
+            if (frame >= opt.warmup)
+                frameMillis.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        }
+
+        double totalMillis = 0.0;
+        for (double ms : frameMillis) totalMillis += ms;
+        double pickSeconds = 0.0;
+        for (double us : pickMicros) pickSeconds += us * 1e-6;
+
+        const double avg = totalMillis / (double)frameMillis.size();
+        const double p50 = percentile(frameMillis, 50.0);
+        const double p90 = percentile(frameMillis, 90.0);
+        const double p99 = percentile(frameMillis, 99.0);
+        const double worst = percentile(frameMillis, 100.0);
+        const double picksPerSecond = pickSeconds > 0.0 ? (double)pickMicros.size() / pickSeconds : 0.0;
+        const double pickP99 = percentile(pickMicros, 99.0);
+
+        std::printf("frame ms: avg %.3f  p50 %.3f  p90 %.3f  p99 %.3f  max %.3f  (%.1f fps)\n",
+            avg, p50, p90, p99, worst, 1000.0 / avg);
+        std::printf("picks: %zu  %.0f picks/s  p99 %.1f us  (hits %u)\n",
+            pickMicros.size(), picksPerSecond, pickP99, pickHits);
+
+        FILE* f = std::fopen(opt.json.c_str(), "w");
+        if (!f) throw std::runtime_error("Failed to write " + opt.json);
+        std::fprintf(f, "{\n");
+        std::fprintf(f, "  \"renderer\": \"%s\",\n", jsonEscape(glString(GL_RENDERER)).c_str());
+        std::fprintf(f, "  \"gl_version\": \"%s\",\n", jsonEscape(glString(GL_VERSION)).c_str());
+        std::fprintf(f, "  \"config\": { \"frames\": %d, \"warmup\": %d, \"objects\": %d, \"faces\": %u, "
+            "\"picks_per_frame\": %d, \"pick_target\": \"%s\", \"pick_mode\": \"%s\", "
+            "\"width\": %d, \"height\": %d, \"cull\": %s, \"finish\": %s },\n",
+            opt.frames, opt.warmup, opt.objects, mesh.faceCount(), opt.picks,
+            opt.pickObjects ? "objects" : "faces", opt.pickCpu ? "cpu" : "gpu", fbW, fbH,
+            opt.cull ? "true" : "false", opt.finish ? "true" : "false");
+        std::fprintf(f, "  \"frame_ms\": { \"avg\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+            avg, p50, p90, p99, worst);
+        std::fprintf(f, "  \"picks\": { \"count\": %zu, \"per_second\": %.1f, \"p99_us\": %.2f, \"hits\": %u }\n",
+            pickMicros.size(), picksPerSecond, pickP99, pickHits);
+        std::fprintf(f, "}\n");
+        std::fclose(f);
+        std::printf("wrote %s\n", opt.json.c_str());
+
+        picker.destroy();
+        renderer.destroy();
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "Fatal: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -1,7 +1,11 @@
 #include "app.h"
 
+#include "algorithm"
 #include "stdexcept"
 #include "memory"
+#include "chrono"
+#include "string_view"
+#include "utility"
 
 #include "glad/glad.h"
 #include "GLFW/glfw3.h"
@@ -12,7 +16,13 @@
 
 #include "glm/gtc/matrix_transform.hpp"
 
+#include "io/mesh_cache.h"
+#include "io/obj_importer.h"
 #include "platform/input.h"
+#include "render/geometry_gen.h"
+#include "render/gl_state.h"
+#include "render/program_registry.h"
+#include "scene/frustum_culler.h"
 
 App::App()
 {
@@ -24,69 +34,163 @@ App::App()
 
     setGLState();
 
+    m_profiler.init();
+    m_prof.input = m_profiler.addCpuSection("input");
+    m_prof.imgui = m_profiler.addCpuSection("imgui_begin");
+    m_prof.update = m_profiler.addCpuSection("update");
+    m_prof.matrices = m_profiler.addCpuSection("matrices");
+    m_prof.picking = m_profiler.addCpuSection("picking");
+    m_prof.ui = m_profiler.addCpuSection("ui");
+    m_prof.render = m_profiler.addCpuSection("render");
+    m_prof.present = m_profiler.addCpuSection("present");
+    m_prof.gpuPick = m_profiler.addGpuSection("pick");
+    m_prof.gpuScene = m_profiler.addGpuSection("scene");
+    m_prof.gpuImGui = m_profiler.addGpuSection("imgui");
+
     // ImGui
     m_imgui = std::make_unique<ImGuiContextGuard>(
         m_platform.window(), "#version 330");
 
+    // Scene（グリッドと編集メッシュ）
+    m_editMesh = geometry_gen::createCube(0.5f);
+    buildScene(0);
+
     // Renderer
-    m_renderer.init();
+    m_renderer.init(m_editMesh);
 
     // Picker（Renderer依存）
     m_picker.init(
         m_platform.window(),
-        m_renderer.cubeSolidVAO()
+        &m_renderer
     );
+    m_picker.setMesh(m_editMesh);
 }
 
 void App::run()
 {
     while (!m_platform.shouldClose())
     {
+        m_profiler.beginFrame();
+
         // ---- 1) input ----
+        m_profiler.beginCpu(m_prof.input);
         m_platform.beginFrame();
+        gl_state::beginFrame();
+        m_profiler.endCpu(m_prof.input);
 
         // ---- 2) ImGui begin ----
+        m_profiler.beginCpu(m_prof.imgui);
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
+        m_profiler.endCpu(m_prof.imgui);
 
         // ---- 3) update ----
+        m_profiler.beginCpu(m_prof.update);
+        m_regionTool.update(m_platform.window());
         updateCameraFromInput();
-        m_picker.updateRequest();
+        if (!m_regionTool.active())
+            m_picker.updateRequest();
+        m_profiler.endCpu(m_prof.update);
 
         // ---- 4) compute matrices ----
+        m_profiler.beginCpu(m_prof.matrices);
         int fbW = 0, fbH = 0;
         m_platform.framebufferSize(fbW, fbH);
-        glm::mat4 vp = computeVP(fbW, fbH);
+        const FrameUniforms frame = computeFrame(fbW, fbH);
+        const glm::mat4& vp = frame.viewProj;
+        m_renderer.beginFrame(frame);   // ピッキングと描画の全プログラムがここから読む
+        m_renderer.setGrid(m_gridEnabled, m_camera.distance());
+
+        m_scene.updateWorld();
+
+        if (m_cullEnabled)
+        {
+            const auto c0 = std::chrono::steady_clock::now();
+            m_visibility.resize(m_scene.nodeCount());
+            m_visibleCount = frustum_cull::cull(Frustum::fromViewProj(vp), m_scene.worldBounds(), m_visibility);
+            const auto c1 = std::chrono::steady_clock::now();
+            m_cullMillis = std::chrono::duration<double, std::milli>(c1 - c0).count();
+        }
+
+        // ピッキングは編集メッシュのローカル空間で行う（MVP を VP として渡す）
+        const glm::mat4 meshVP = vp * m_scene.world(m_meshNode);
+
+        m_profiler.endCpu(m_prof.matrices);
 
         // ---- 5) picking ----
+        // オブジェクトはワールドの VP、面は編集メッシュの MVP で引く
+        m_profiler.beginCpu(m_prof.picking);
+        m_profiler.beginGpu(m_prof.gpuPick);
+        const bool pickObjects = (m_picker.target() == PickTarget::Objects);
+        const glm::mat4& pickVP = pickObjects ? vp : meshVP;
+
         if (m_picker.hasRequest())
-            m_selectedFace = m_picker.pick(vp, fbW, fbH);
+        {
+            const uint32_t id = m_picker.pick(pickVP, fbW, fbH);
+            if (pickObjects)
+            {
+                if (id != 0) setActiveNode(id - 1);
+            }
+            else
+            {
+                m_selection.clear();
+                if (id != 0) m_selection.add(id);
+            }
+        }
+
+        ScreenRegion region;
+        if (m_regionTool.takeResult(region))
+            m_selection.set(m_picker.pickRegion(meshVP, fbW, fbH, region, m_selectOccluded));
+
+        if (m_hoverEnabled)
+            m_picker.updateHover(pickVP, fbW, fbH);
+        const uint32_t hovered = m_hoverEnabled ? m_picker.hoveredId() : 0;
+        m_hoveredFace = pickObjects ? 0 : hovered;
+        m_hoveredNode = pickObjects ? hovered : 0;
+        m_profiler.endGpu(m_prof.gpuPick);
+        m_profiler.endCpu(m_prof.picking);
 
         // ---- 6) UI ----
-        drawUI();
+        {
+            FrameProfiler::CpuScope scope(m_profiler, m_prof.ui);
+            drawUI();
+        }
 
         // ---- 7) render ----
+        m_profiler.beginCpu(m_prof.render);
         ImGui::Render();
 
-        m_renderer.draw(vp, fbW, fbH, m_selectedFace);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            FrameProfiler::GpuScope gpu(m_profiler, m_prof.gpuScene);
+            m_renderer.draw(m_scene, m_selection, m_hoveredFace,
+                m_cullEnabled ? std::span<const uint8_t>(m_visibility) : std::span<const uint8_t>());
+        }
+        {
+            FrameProfiler::GpuScope gpu(m_profiler, m_prof.gpuImGui);
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+        m_profiler.endCpu(m_prof.render);
 
+        m_profiler.beginCpu(m_prof.present);
         glfwSwapBuffers(m_platform.window());
+        m_profiler.endCpu(m_prof.present);
+
+        m_profiler.endFrame();
     }
 }
 
 void App::setGLState()
 {
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDepthMask(GL_TRUE);
+    gl_state::enable(GL_DEPTH_TEST);
+    gl_state::depthFunc(GL_LESS);
+    gl_state::depthMask(true);
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gl_state::enable(GL_BLEND);
+    gl_state::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // sRGB（今は保留でもOK）
-    glEnable(GL_FRAMEBUFFER_SRGB);
+    gl_state::enable(GL_FRAMEBUFFER_SRGB);
 }
 
 void App::updateCameraFromInput()
@@ -96,7 +200,8 @@ void App::updateCameraFromInput()
 
     const InputState& in = m_platform.input();
 
-    if (in.m_leftDown)
+    // 矩形 / 投げ縄ドラッグ中は回転しない
+    if (in.m_leftDown && !m_regionTool.active())
         m_camera.orbit((float)in.m_deltaX, (float)in.m_deltaY);
 
     if (in.m_middleDown)
@@ -109,18 +214,371 @@ void App::updateCameraFromInput()
     m_camera.zoom((float)in.m_scrollY);
 }
 
-glm::mat4 App::computeVP(int fbW, int fbH) const
+FrameUniforms App::computeFrame(int fbW, int fbH)
 {
     const float aspect = (fbH > 0) ? (float)fbW / (float)fbH : 1.0f;
     glm::mat4 view = m_camera.viewMatrix();
     glm::mat4 proj = glm::perspectiveRH(60.0f * 3.1415926f / 180.0f, aspect, 0.1f, 1000.0f);
-    return proj * view;
+
+    const double now = glfwGetTime();
+    const float delta = m_frameIndex > 0 ? (float)(now - m_lastFrameTime) : 0.0f;
+    m_lastFrameTime = now;
+    return FrameUniforms::make(view, proj, fbW, fbH, (float)now, delta, m_frameIndex++);
 }
 
 void App::drawUI()
 {
+    m_regionTool.drawOverlay();
+
     ImGui::Begin("Debug");
-    ImGui::Text("Selected Face: %u", m_selectedFace);
+    ImGui::Text("Selected Faces: %zu", m_selection.size());
+    ImGui::Text("Hovered Face: %u  Node: %u", m_hoveredFace, m_hoveredNode);
+    ImGui::Checkbox("Hover highlight", &m_hoverEnabled);
+    ImGui::Checkbox("Grid", &m_gridEnabled);
+    ImGui::Checkbox("Select occluded (Shift/Ctrl drag)", &m_selectOccluded);
+    ImGui::Text("Last region pick: %.3f ms", m_picker.lastRegionMillis());
+
+    const float prevOffset = m_faceOffset;
+    if (ImGui::DragFloat("Offset selected faces", &m_faceOffset, 0.005f) && !m_selection.empty())
+        offsetSelectedFaces(m_faceOffset - prevOffset);
+    if (ImGui::IsItemDeactivatedAfterEdit())
+    {
+        m_faceOffset = 0.0f;
+        m_picker.setMesh(m_editMesh);
+        updateMeshBounds();
+    }
+    ImGui::Text("GPU upload: %.1f KB / frame", m_renderer.lastUploadBytes() / 1024.0);
+
+    int mode = (int)m_picker.mode();
+    ImGui::RadioButton("GPU ID buffer", &mode, (int)PickMode::GpuIdBuffer);
+    ImGui::SameLine();
+    ImGui::RadioButton("CPU BVH", &mode, (int)PickMode::CpuBvh);
+    m_picker.setMode((PickMode)mode);
+
+    int target = (int)m_picker.target();
+    ImGui::RadioButton("Pick faces", &target, (int)PickTarget::Faces);
+    ImGui::SameLine();
+    ImGui::RadioButton("Pick objects", &target, (int)PickTarget::Objects);
+    m_picker.setTarget((PickTarget)target);
+    ImGui::Text("Last pick: %.1f us", m_picker.lastPickMicros());
+
+    bool localPick = m_picker.localPick();
+    if (ImGui::Checkbox("Cursor-local pick pass", &localPick))
+        m_picker.setLocalPick(localPick);
+    ImGui::Text("Pick target: %dx%d", m_picker.pickTargetWidth(), m_picker.pickTargetHeight());
+
     ImGui::Text("Yaw: %.3f  Pitch: %.3f  Dist: %.3f", m_camera.yaw(), m_camera.pitch(), m_camera.distance());
+
+    const GeometryPool::Stats pool = m_renderer.poolStats();
+    ImGui::Text("Geometry pool: V %u/%u  I %u/%u  (%u allocs, %u free blocks)",
+        pool.vertexUsed, pool.vertexCapacity, pool.indexUsed, pool.indexCapacity, pool.allocations, pool.freeBlocks);
+    ImGui::Text("  grows: %u  compactions: %u", pool.grows, pool.compactions);
+    const StreamBuffer::Stats stream = m_renderer.streamStats();
+    ImGui::Text("Stream ring: %zu / %zu KB per frame  (waits: %u, grows: %u)",
+        stream.usedBytes / 1024, stream.segmentBytes / 1024, stream.waits, stream.grows);
+    const gl_state::Stats glCalls = gl_state::lastFrame();
+    ImGui::Text("GL state calls: %u issued, %u skipped", glCalls.issued, glCalls.skipped);
+    const program_registry::Stats programs = program_registry::stats();
+    ImGui::Text("Programs: %u  (compiled %u, binary cache %u, rejected %u, %.1f ms)",
+        programs.programs, programs.compiled, programs.cacheHits, programs.cacheRejected, programs.buildMillis);
+    const ShaderVariants::Stats variants = m_renderer.lineVariantStats();
+    ImGui::Text("Line shader variants: %u ready, %u compiling  (fallback draws: %u)",
+        variants.ready, variants.pending, variants.fallbacks);
+    const RenderQueue::Stats queue = m_renderer.queueStats();
+    ImGui::Text("Render queue: %u draws  (programs: %u, VAOs: %u, uniforms: %u)",
+        queue.packets, queue.programChanges, queue.vaoChanges, queue.uniformUploads);
+
+    drawProfilerUI();
+
+    ImGui::Separator();
+    ImGui::Text("Scene nodes: %u  (world updated: %u)", m_scene.nodeCount(), m_scene.lastUpdatedCount());
+
+    ImGui::Checkbox("Frustum culling", &m_cullEnabled);
+    if (m_cullEnabled)
+    {
+        ImGui::Text("Visible: %u  Culled: %u  (%.3f ms)",
+            m_visibleCount, m_scene.nodeCount() - m_visibleCount, m_cullMillis);
+    }
+
+    ImGui::DragInt("Parts N x N", &m_partGrid, 1.0f, 1, 400);
+    if (ImGui::Button("Spawn parts"))
+        buildScene(m_partGrid);
+    ImGui::SameLine();
+    if (ImGui::Button("Clear parts"))
+        buildScene(0);
+
+    ImGui::Text("Active node: %u", m_activeNode);
+    ImGui::SameLine();
+    if (ImGui::Button("Edit mesh") && m_activeNode != m_meshNode)
+        setActiveNode(m_meshNode);
+    if (m_partsRoot != Scene::kNoParent)
+    {
+        ImGui::SameLine();
+        if (ImGui::Button("Parts root"))
+            setActiveNode(m_partsRoot);
+    }
+
+    glm::vec3 t = m_scene.translation(m_activeNode);
+    if (ImGui::DragFloat3("Translate", &t.x, 0.01f))
+        m_scene.setTranslation(m_activeNode, t);
+    if (ImGui::DragFloat3("Rotate", &m_activeEulerDeg.x, 0.5f))
+        m_scene.setRotation(m_activeNode, glm::quat(glm::radians(m_activeEulerDeg)));
+    glm::vec3 sc = m_scene.scale(m_activeNode);
+    if (ImGui::DragFloat3("Scale", &sc.x, 0.01f, 0.01f, 100.0f))
+        m_scene.setScale(m_activeNode, sc);
+
+    ImGui::Separator();
+    ImGui::InputText("OBJ / AQM", m_importPath, sizeof(m_importPath));
+    ImGui::RadioButton("Float", &m_importFormat, (int)VertexFormat::Full);
+    ImGui::SameLine();
+    ImGui::RadioButton("Packed", &m_importFormat, (int)VertexFormat::Packed);
+    ImGui::SameLine();
+    ImGui::RadioButton("Packed + quantized", &m_importFormat, (int)VertexFormat::Quantized);
+    if (ImGui::Button("Import"))
+        importMesh(m_importPath);
+    if (!m_importStatus.empty())
+        ImGui::TextUnformatted(m_importStatus.c_str());
+
+    ImGui::Separator();
+    ImGui::InputText("Export path", m_exportPath, sizeof(m_exportPath));
+    ImGui::RadioButton("OBJ", &m_exportFormat, (int)ExportFormat::Obj);
+    ImGui::SameLine();
+    ImGui::RadioButton("PLY (binary)", &m_exportFormat, (int)ExportFormat::PlyBinary);
+
+    if (m_exportTask.running())
+    {
+        ImGui::ProgressBar(m_exportTask.progress());
+        if (ImGui::Button("Cancel export"))
+            m_exportTask.cancel();
+    }
+    else if (ImGui::Button("Export"))
+    {
+        // 書き出し中も編集できるよう、その時点の形状を複製して渡す
+        m_exportTask.start(m_exportPath, (ExportFormat)m_exportFormat, ExportMesh::fromEditMesh(m_editMesh));
+        m_exportStatus = "Exporting...";
+    }
+
+    m_exportTask.takeResult(m_exportStatus);
+    if (!m_exportStatus.empty())
+        ImGui::TextUnformatted(m_exportStatus.c_str());
+
     ImGui::End();
 }
+
+void App::drawProfilerUI()
+{
+    ImGui::Separator();
+
+    // 直近 FrameProfiler::kWindow フレーム（GPU は結果が届いたフレームのみ）
+    const RollingStats& frame = m_profiler.frameStats();
+    ImGui::Text("Frame: min %.2f  avg %.2f  p99 %.2f ms", frame.min(), frame.average(), frame.percentile(99.0));
+    for (FrameProfiler::Section s = 0; s < m_profiler.sectionCount(); ++s)
+    {
+        const RollingStats& st = m_profiler.stats(s);
+        ImGui::Text("  %s %-12s min %.3f  avg %.3f  p99 %.3f ms", m_profiler.isGpu(s) ? "GPU" : "CPU",
+            m_profiler.name(s).c_str(), st.min(), st.average(), st.percentile(99.0));
+    }
+    if (m_profiler.droppedGpuSamples() > 0)
+        ImGui::Text("  GPU results not ready (dropped): %u", m_profiler.droppedGpuSamples());
+
+    ImGui::InputText("Profile CSV", m_profileCsvPath, sizeof(m_profileCsvPath));
+    if (m_profiler.csvActive())
+    {
+        if (ImGui::Button("Stop CSV"))
+            m_profiler.stopCsv();
+        ImGui::SameLine();
+        ImGui::Text("writing %s", m_profiler.csvPath().c_str());
+    }
+    else if (ImGui::Button("Start CSV"))
+    {
+        m_profiler.startCsv(m_profileCsvPath);
+    }
+}
+
+void App::buildScene(int partGrid)
+{
+    m_scene.clear();
+    m_meshNode = m_scene.addNode(Scene::kNoParent, Renderer::kEditMesh);
+    m_partsRoot = Scene::kNoParent;
+
+    if (partGrid > 0)
+    {
+        // 同じ立方体を N×N 個。親を動かすと全部がついてくる
+        const size_t n = (size_t)partGrid;
+        m_scene.reserve(1 + 1 + n * n);
+        m_partsRoot = m_scene.addNode();
+        m_scene.setTranslation(m_partsRoot, glm::vec3(0.0f, -1.0f, 0.0f));
+
+        const float spacing = 1.5f;
+        const float origin = -0.5f * spacing * (float)(n - 1);
+        for (size_t z = 0; z < n; ++z)
+        {
+            for (size_t x = 0; x < n; ++x)
+            {
+                const uint32_t node = m_scene.addNode(m_partsRoot, Renderer::kPartMesh);
+                m_scene.setTranslation(node, glm::vec3(origin + spacing * x, 0.0f, origin + spacing * z));
+                m_scene.setScale(node, glm::vec3(0.5f));
+                m_scene.setLocalBounds(node, glm::vec3(-0.5f), glm::vec3(0.5f));
+                m_scene.setColor(node, glm::vec4(
+                    0.3f + 0.7f * (float)x / (float)n,
+                    0.5f,
+                    0.3f + 0.7f * (float)z / (float)n,
+                    1.0f));
+            }
+        }
+    }
+
+    updateMeshBounds();
+    setActiveNode(m_meshNode);
+}
+
+void App::updateMeshBounds()
+{
+    const std::vector<glm::vec3>& positions = m_editMesh.positions();
+    if (positions.empty())
+    {
+        m_scene.setUnbounded(m_meshNode);
+        return;
+    }
+
+    glm::vec3 bmin = positions[0], bmax = positions[0];
+    for (const glm::vec3& p : positions)
+    {
+        bmin = glm::min(bmin, p);
+        bmax = glm::max(bmax, p);
+    }
+    m_scene.setLocalBounds(m_meshNode, bmin, bmax);
+}
+
+void App::offsetSelectedFaces(float distance)
+{
+    // 選択面の頂点を、その頂点に接する選択面の法線の平均方向へ動かす
+    std::vector<std::pair<uint32_t, glm::vec3>> contrib;
+    for (uint32_t id : m_selection.ids())
+    {
+        if (id == 0 || id > m_editMesh.faceCount()) continue;
+        const glm::vec3 n = m_editMesh.faceNormal(id - 1);
+        m_editMesh.forEachFaceVertex(id - 1, [&](uint32_t v) { contrib.emplace_back(v, n); });
+    }
+    std::sort(contrib.begin(), contrib.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<uint32_t> moved;
+    for (size_t i = 0; i < contrib.size();)
+    {
+        const uint32_t v = contrib[i].first;
+        glm::vec3 n(0.0f);
+        for (; i < contrib.size() && contrib[i].first == v; ++i)
+            n += contrib[i].second;
+
+        const float len = glm::length(n);
+        if (len <= 0.0f) continue;
+        m_editMesh.setPosition(v, m_editMesh.position(v) + n * (distance / len));
+        moved.push_back(v);
+    }
+
+    // GPU には動いた頂点の分だけ送る（BVH と境界はドラッグを離したときに作り直す）
+    m_renderer.updatePositions(m_editMesh, moved);
+}
+
+void App::setActiveNode(uint32_t node)
+{
+    m_activeNode = node;
+    m_activeEulerDeg = glm::degrees(glm::eulerAngles(m_scene.rotation(node)));
+}
+
+void App::importMesh(const char* path)
+{
+    const std::string_view p(path);
+    if (p.ends_with(".aqm"))
+    {
+        loadMeshCache(path);
+        return;
+    }
+
+    // OBJ の隣に置いたキャッシュが新しければ再解析しない
+    // 読めなければ（古い版・壊れている）解析し直してキャッシュを書き直す
+    const std::string cachePath = std::string(path) + ".aqm";
+    if (mesh_cache::isUpToDate(cachePath.c_str(), path) && loadMeshCache(cachePath.c_str()))
+        return;
+
+    try
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        ObjMeshData obj = obj_importer::load(path);
+        const auto t1 = std::chrono::steady_clock::now();
+
+        // 投げうるものはローカルに作ってから差し替える（失敗したら今のメッシュのまま）
+        EditMesh mesh = obj_importer::buildEditMesh(obj);
+        const VertexFormat format = (VertexFormat)m_importFormat;
+        m_renderer.setMesh(mesh, obj.vertices, obj.indices, format, obj.vertexNormals, obj.vertexTexcoords);
+        m_editMesh = std::move(mesh);
+        m_picker.setMesh(m_editMesh);
+        m_selection.clear();
+        updateMeshBounds();
+
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "%zu verts, %zu faces (parse %.1f ms, %.1f MB on GPU)",
+            obj.vertices.size(), obj.faceSizes.size(),
+            std::chrono::duration<double, std::milli>(t1 - t0).count(),
+            obj.vertices.size() * (double)m_renderer.poolStats(format).vertexStride / (1024.0 * 1024.0));
+        m_importStatus = buf;
+
+        // twin も残しておけば、次回は辺の対を探すソートを省ける
+        const mesh_cache::PolygonData polygons{ obj.positions, obj.faceSizes, obj.faceIndices,
+            m_editMesh.halfEdgeTwin(), m_editMesh.edgeCount() };
+        const mesh_cache::AttributeData attributes{ obj.vertexNormals, obj.vertexTexcoords };
+        mesh_cache::save(cachePath.c_str(), obj.vertices, obj.indices, &polygons, &attributes);
+    }
+    catch (const std::exception& e)
+    {
+        m_importStatus = e.what();
+    }
+}
+
+bool App::loadMeshCache(const char* path)
+{
+    try
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        const mesh_cache::View cache(path);
+
+        // 投げうるものはローカルに作ってから差し替える（失敗したら今のメッシュのまま）
+        // twin 区画があれば buildTwins のソートを省く
+        const mesh_cache::PolygonData& poly = cache.polygons();
+        EditMesh mesh;
+        if (cache.hasPolygons())
+        {
+            mesh = poly.twins.empty()
+                ? EditMesh::fromPolygons(poly.positions, poly.faceSizes, poly.faceIndices)
+                : EditMesh::fromPolygons(poly.positions, poly.faceSizes, poly.faceIndices, poly.twins, poly.edgeCount);
+        }
+
+        // 面は EditMesh から作らず、キャッシュの頂点列だけを送る
+        // Full なら頂点・インデックスはマップ領域から直接 glBufferData へ
+        // 圧縮形式を選んでいればキャッシュの法線・UV と合わせて変換してから送る
+        m_renderer.setMesh(mesh, cache.vertices(), cache.indices(), (VertexFormat)m_importFormat,
+            cache.normals(), cache.texcoords());
+
+        // BVH は CPU ピックで初めて要るときに作る
+        m_editMesh = std::move(mesh);
+        m_picker.setMesh(m_editMesh);
+        m_selection.clear();
+
+        if (cache.hasPolygons()) updateMeshBounds();
+        else m_scene.setLocalBounds(m_meshNode, cache.boundsMin(), cache.boundsMax());
+        const auto t1 = std::chrono::steady_clock::now();
+
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "%zu verts, %zu faces (cache %.1f ms)",
+            cache.vertices().size(), poly.faceSizes.size(),
+            std::chrono::duration<double, std::milli>(t1 - t0).count());
+        m_importStatus = buf;
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        m_importStatus = e.what();
+        return false;
+    }
+}
@@ -2,14 +2,23 @@
 
 #include "stdexcept"
 #include "memory"
+#include "string"
+#include "vector"
 
 #include "glm/glm.hpp"
 
 #include "camera/orbit_camera.h"
+#include "io/export_task.h"
+#include "mesh/edit_mesh.h"
 #include "platform/imgui_context_guard.h"
 #include "platform/platform.h"
+#include "profile/frame_profiler.h"
+#include "render/frame_uniforms.h"
 #include "render/renderer.h"
 #include "render/picker.h"
+#include "scene/scene.h"
+#include "select/face_selection.h"
+#include "select/region_select_tool.h"
 
 class App
 {
@@ -23,13 +32,67 @@ private:
     Platform m_platform;
     std::unique_ptr<ImGuiContextGuard> m_imgui;
 
+    EditMesh m_editMesh;
+
+    Scene     m_scene;
+    uint32_t  m_meshNode = Scene::kNoParent;
+    uint32_t  m_partsRoot = Scene::kNoParent;
+    int       m_partGrid = 100;              ///< 部品を N×N 個並べる
+    uint32_t  m_activeNode = Scene::kNoParent;  ///< Transform の編集対象
+    glm::vec3 m_activeEulerDeg{ 0.0f };     ///< UI 用（クォータニオンから戻すと揺れるので保持しておく）
+
+    // --- Frustum culling ---
+    bool     m_cullEnabled = true;
+    std::vector<uint8_t> m_visibility;      ///< ノードごと（1 = 見える）
+    uint32_t m_visibleCount = 0;
+    double   m_cullMillis = 0.0;
+
     Renderer m_renderer;
     Picker   m_picker;
 
+    // --- Profiling ---
+    // run() の各段階（CPU）と GPU のパス
+    struct ProfileSections
+    {
+        FrameProfiler::Section input, imgui, update, matrices, picking, ui, render, present;
+        FrameProfiler::Section gpuPick, gpuScene, gpuImGui;
+    };
+    FrameProfiler   m_profiler;
+    ProfileSections m_prof{};
+    char            m_profileCsvPath[512] = "frame_profile.csv";
+
     OrbitCamera m_camera;
-    uint32_t m_selectedFace = 0;
+    RegionSelectTool m_regionTool;
+    FaceSelection    m_selection;
+    uint32_t m_hoveredFace = 0;
+    uint32_t m_hoveredNode = 0;             ///< node + 1（Objects ピック時）
+    bool     m_hoverEnabled = true;
+    bool     m_gridEnabled = true;
+    bool     m_selectOccluded = false;
+    float    m_faceOffset = 0.0f;           ///< ドラッグ中に選択面を法線方向へ動かした量
+
+    double   m_lastFrameTime = 0.0;         ///< glfwGetTime()（FrameUniforms::time 用）
+    uint32_t m_frameIndex = 0;
+
+    char        m_importPath[512] = "";
+    int         m_importFormat = (int)VertexFormat::Full;  ///< 読み込んだ面の GPU 頂点形式
+    std::string m_importStatus;
+
+    ExportTask  m_exportTask;
+    char        m_exportPath[512] = "export.obj";
+    int         m_exportFormat = (int)ExportFormat::Obj;
+    std::string m_exportStatus;
+
     static void setGLState();
     void updateCameraFromInput();
-    glm::mat4 computeVP(int fbW, int fbH) const;
+    FrameUniforms computeFrame(int fbW, int fbH);
     void drawUI();
+    void drawProfilerUI();
+    void buildScene(int partGrid);
+    void setActiveNode(uint32_t node);
+    void updateMeshBounds();
+    void offsetSelectedFaces(float distance);
+    void importMesh(const char* path);
+    /// @return 読めたか（失敗時は m_importStatus に理由）
+    bool loadMeshCache(const char* path);
 };
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "io/export_task.h"
+
+#include "chrono"
+#include "cstdio"
+#include "exception"
+
+ExportTask::~ExportTask()
+{
+    cancel();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool ExportTask::start(std::string path, ExportFormat format, ExportMesh mesh)
+{
+    if (running()) return false;
+    if (m_thread.joinable()) m_thread.join();
+
+    m_progress.done = 0;
+    m_progress.total = 0;
+    m_progress.cancel = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hasResult = false;
+        m_result.clear();
+    }
+
+    m_running = true;
+    m_thread = std::thread([this, path = std::move(path), format, mesh = std::move(mesh)]
+        {
+            std::string message;
+            try
+            {
+                const auto t0 = std::chrono::steady_clock::now();
+                mesh_exporter::write(path.c_str(), format, mesh, &m_progress);
+                const auto t1 = std::chrono::steady_clock::now();
+
+                char buf[160];
+                std::snprintf(buf, sizeof(buf), "Exported %zu verts, %zu faces (%.1f ms)",
+                    mesh.positions.size(), mesh.faceSizes.size(),
+                    std::chrono::duration<double, std::milli>(t1 - t0).count());
+                message = buf;
+            }
+            catch (const std::exception& e)
+            {
+                message = e.what();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_result = std::move(message);
+                m_hasResult = true;
+            }
+            m_running.store(false, std::memory_order_release);
+        });
+    return true;
+}
+
+float ExportTask::progress() const
+{
+    const uint64_t total = m_progress.total.load(std::memory_order_relaxed);
+    if (total == 0) return 0.0f;
+    return (float)((double)m_progress.done.load(std::memory_order_relaxed) / (double)total);
+}
+
+bool ExportTask::takeResult(std::string& message)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_hasResult) return false;
+
+    message = std::move(m_result);
+    m_hasResult = false;
+    return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "atomic"
+#include "mutex"
+#include "string"
+#include "thread"
+
+#include "io/mesh_exporter.h"
+
+/**
+ * @brief メッシュ書き出しのバックグラウンドタスク
+ *
+ * start() でメッシュの複製を受け取り、専用スレッドで mesh_exporter::write を実行する。
+ * UI スレッドは毎フレーム progress() を読み、takeResult() で完了を受け取る。
+ * 破棄時は中断して終了を待つ。
+ */
+class ExportTask
+{
+public:
+    ExportTask() = default;
+    ~ExportTask();
+
+    ExportTask(const ExportTask&) = delete;
+    ExportTask& operator=(const ExportTask&) = delete;
+
+    /// 実行中なら何もせず false
+    bool start(std::string path, ExportFormat format, ExportMesh mesh);
+
+    bool running() const { return m_running.load(std::memory_order_acquire); }
+    void cancel() { m_progress.cancel = true; }
+
+    /// 0..1
+    float progress() const;
+
+    /**
+     * @brief 完了した結果を受け取る
+     *
+     * 完了後の最初の呼び出しだけ true を返し、message に結果を入れる。
+     */
+    bool takeResult(std::string& message);
+
+private:
+    std::thread m_thread;
+    std::atomic<bool> m_running{ false };
+    ExportProgress m_progress;
+
+    std::mutex  m_mutex;
+    std::string m_result;
+    bool        m_hasResult = false;
+};
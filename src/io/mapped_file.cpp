@@ -0,0 +1,126 @@
+#include "io/mapped_file.h"
+
+#include "stdexcept"
+#include "string"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include "windows.h"
+#else
+#include "fcntl.h"
+#include "sys/mman.h"
+#include "sys/stat.h"
+#include "unistd.h"
+#endif
+
+MappedFile::MappedFile(const char* path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error(std::string("Failed to open file: ") + path);
+    m_file = file;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size))
+    {
+        close();
+        throw std::runtime_error(std::string("Failed to get file size: ") + path);
+    }
+    m_size = (size_t)size.QuadPart;
+    if (m_size == 0) return;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        close();
+        throw std::runtime_error(std::string("Failed to map file: ") + path);
+    }
+    m_mapping = mapping;
+
+    m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    m_fd = ::open(path, O_RDONLY);
+    if (m_fd < 0)
+        throw std::runtime_error(std::string("Failed to open file: ") + path);
+
+    struct stat st {};
+    if (::fstat(m_fd, &st) != 0)
+    {
+        close();
+        throw std::runtime_error(std::string("Failed to get file size: ") + path);
+    }
+    m_size = (size_t)st.st_size;
+    if (m_size == 0) return;
+
+    void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (p != MAP_FAILED)
+    {
+        ::madvise(p, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(p);
+    }
+#endif
+
+    if (!m_data)
+    {
+        close();
+        throw std::runtime_error(std::string("Failed to map file: ") + path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    moveFrom(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        moveFrom(other);
+    }
+    return *this;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = nullptr;
+#else
+    if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+void MappedFile::moveFrom(MappedFile& other) noexcept
+{
+    m_data = other.m_data;
+    m_size = other.m_size;
+    other.m_data = nullptr;
+    other.m_size = 0;
+
+#ifdef _WIN32
+    m_file = other.m_file;
+    m_mapping = other.m_mapping;
+    other.m_file = nullptr;
+    other.m_mapping = nullptr;
+#else
+    m_fd = other.m_fd;
+    other.m_fd = -1;
+#endif
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "cstddef"
+#include "string_view"
+
+/**
+ * @brief 読み取り専用のメモリマップドファイル（RAII）
+ *
+ * Windows は CreateFileMapping / MapViewOfFile、それ以外は mmap。
+ * 開けない場合は std::runtime_error を投げる。
+ * 空ファイルはマップせず size() == 0 になる。
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const char* path);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    std::string_view view() const { return std::string_view(m_data, m_size); }
+
+    void close();
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+
+    void moveFrom(MappedFile& other) noexcept;
+};
@@ -0,0 +1,203 @@
+#include "io/mesh_cache.h"
+
+#include "cstddef"
+#include "cstdio"
+#include "cstring"
+#include "filesystem"
+#include "limits"
+#include "stdexcept"
+#include "string"
+#include "system_error"
+
+namespace
+{
+    constexpr uint64_t kAlign = 16;
+
+    uint64_t alignUp(uint64_t v)
+    {
+        return (v + kAlign - 1) & ~(kAlign - 1);
+    }
+
+    void writeAt(std::FILE* f, uint64_t& pos, uint64_t target, const void* data, size_t bytes)
+    {
+        static const char kZeros[kAlign] = {};
+        if (target > pos) std::fwrite(kZeros, 1, (size_t)(target - pos), f);
+        if (bytes) std::fwrite(data, 1, bytes, f);
+        pos = target + bytes;
+    }
+
+    // 区画 [offset, offset + count * elemSize) がファイル内に収まり、整列しているか
+    template <class T>
+    std::span<const T> section(const MappedFile& file, uint64_t offset, uint64_t count)
+    {
+        if (count == 0) return {};
+        if (offset % alignof(T) != 0 || offset > file.size() ||
+            count > (file.size() - offset) / sizeof(T))
+            throw std::runtime_error("mesh_cache: section out of range");
+        return std::span<const T>(reinterpret_cast<const T*>(file.data() + offset), (size_t)count);
+    }
+}
+
+void mesh_cache::save(const char* path,
+    std::span<const Vertex> vertices,
+    std::span<const uint32_t> indices,
+    const PolygonData* polygons,
+    const AttributeData* attributes)
+{
+    Header h{};
+    h.magic = kMagic;
+    h.version = kVersion;
+    h.vertexStride = (uint32_t)sizeof(Vertex);
+    h.positionOffset = (uint32_t)offsetof(Vertex, position);
+    h.colorOffset = (uint32_t)offsetof(Vertex, color);
+
+    h.vertexCount = vertices.size();
+    h.indexCount = indices.size();
+    if (attributes)
+    {
+        if ((!attributes->normals.empty() && attributes->normals.size() != vertices.size()) ||
+            (!attributes->texcoords.empty() && attributes->texcoords.size() != vertices.size()))
+            throw std::runtime_error("mesh_cache: attribute count does not match vertices");
+        h.normalCount = attributes->normals.size();
+        h.texcoordCount = attributes->texcoords.size();
+    }
+    if (polygons)
+    {
+        h.positionCount = polygons->positions.size();
+        h.faceCount = polygons->faceSizes.size();
+        h.faceIndexCount = polygons->faceIndices.size();
+        if (!polygons->twins.empty() && polygons->twins.size() != polygons->faceIndices.size())
+            throw std::runtime_error("mesh_cache: twin count does not match face indices");
+        h.twinCount = polygons->twins.size();
+        h.edgeCount = polygons->edgeCount;
+    }
+
+    h.vertexByteOffset = alignUp(sizeof(Header));
+    h.indexByteOffset = alignUp(h.vertexByteOffset + vertices.size_bytes());
+    h.normalByteOffset = alignUp(h.indexByteOffset + indices.size_bytes());
+    h.texcoordByteOffset = alignUp(h.normalByteOffset + h.normalCount * sizeof(glm::vec3));
+    h.positionByteOffset = alignUp(h.texcoordByteOffset + h.texcoordCount * sizeof(glm::vec2));
+    h.faceSizeByteOffset = alignUp(h.positionByteOffset + h.positionCount * sizeof(glm::vec3));
+    h.faceIndexByteOffset = alignUp(h.faceSizeByteOffset + h.faceCount * sizeof(uint32_t));
+    h.twinByteOffset = alignUp(h.faceIndexByteOffset + h.faceIndexCount * sizeof(uint32_t));
+
+    glm::vec3 bmin(0.0f), bmax(0.0f);
+    if (!vertices.empty())
+    {
+        bmin = glm::vec3(std::numeric_limits<float>::max());
+        bmax = glm::vec3(std::numeric_limits<float>::lowest());
+        for (const Vertex& v : vertices)
+        {
+            bmin = glm::min(bmin, v.position);
+            bmax = glm::max(bmax, v.position);
+        }
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        h.boundsMin[i] = bmin[i];
+        h.boundsMax[i] = bmax[i];
+    }
+
+    const std::string tmpPath = std::string(path) + ".tmp";
+    std::FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) throw std::runtime_error(std::string("mesh_cache: cannot write ") + tmpPath);
+
+    // 区画ごとの大きな fwrite になるのでバッファを大きめに
+    std::setvbuf(f, nullptr, _IOFBF, 1 << 20);
+
+    uint64_t pos = 0;
+    writeAt(f, pos, 0, &h, sizeof(h));
+    writeAt(f, pos, h.vertexByteOffset, vertices.data(), vertices.size_bytes());
+    writeAt(f, pos, h.indexByteOffset, indices.data(), indices.size_bytes());
+    if (attributes)
+    {
+        writeAt(f, pos, h.normalByteOffset, attributes->normals.data(), attributes->normals.size_bytes());
+        writeAt(f, pos, h.texcoordByteOffset, attributes->texcoords.data(), attributes->texcoords.size_bytes());
+    }
+    if (polygons)
+    {
+        writeAt(f, pos, h.positionByteOffset, polygons->positions.data(), polygons->positions.size_bytes());
+        writeAt(f, pos, h.faceSizeByteOffset, polygons->faceSizes.data(), polygons->faceSizes.size_bytes());
+        writeAt(f, pos, h.faceIndexByteOffset, polygons->faceIndices.data(), polygons->faceIndices.size_bytes());
+        writeAt(f, pos, h.twinByteOffset, polygons->twins.data(), polygons->twins.size_bytes());
+    }
+
+    const bool ok = !std::ferror(f);
+    if (std::fclose(f) != 0 || !ok)
+    {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error(std::string("mesh_cache: write failed ") + tmpPath);
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::remove(tmpPath.c_str());
+        throw std::runtime_error(std::string("mesh_cache: cannot replace ") + path);
+    }
+}
+
+mesh_cache::View::View(const char* path)
+    : m_file(path)
+{
+    if (m_file.size() < sizeof(Header))
+        throw std::runtime_error(std::string("mesh_cache: file too small ") + path);
+
+    // マップ先頭はページ境界なので Header をそのまま参照できる
+    m_header = reinterpret_cast<const Header*>(m_file.data());
+    const Header& h = *m_header;
+
+    if (h.magic != kMagic)
+        throw std::runtime_error(std::string("mesh_cache: not a mesh cache ") + path);
+    if (h.version != kVersion)
+        throw std::runtime_error(std::string("mesh_cache: unsupported version ") + path);
+    if (h.vertexStride != sizeof(Vertex) ||
+        h.positionOffset != offsetof(Vertex, position) ||
+        h.colorOffset != offsetof(Vertex, color))
+        throw std::runtime_error(std::string("mesh_cache: vertex layout mismatch ") + path);
+
+    m_vertices = section<Vertex>(m_file, h.vertexByteOffset, h.vertexCount);
+    m_indices = section<uint32_t>(m_file, h.indexByteOffset, h.indexCount);
+
+    // インデックスはそのまま GPU へ渡るので、範囲外の頂点を指すファイルはここで拒否する
+    for (uint32_t i : m_indices)
+        if (i >= h.vertexCount)
+            throw std::runtime_error(std::string("mesh_cache: index out of range ") + path);
+
+    if ((h.normalCount != 0 && h.normalCount != h.vertexCount) ||
+        (h.texcoordCount != 0 && h.texcoordCount != h.vertexCount))
+        throw std::runtime_error(std::string("mesh_cache: attribute count mismatch ") + path);
+    m_attributes.normals = section<glm::vec3>(m_file, h.normalByteOffset, h.normalCount);
+    m_attributes.texcoords = section<glm::vec2>(m_file, h.texcoordByteOffset, h.texcoordCount);
+
+    m_polygons.positions = section<glm::vec3>(m_file, h.positionByteOffset, h.positionCount);
+    m_polygons.faceSizes = section<uint32_t>(m_file, h.faceSizeByteOffset, h.faceCount);
+    m_polygons.faceIndices = section<uint32_t>(m_file, h.faceIndexByteOffset, h.faceIndexCount);
+
+    // 中身（対になっているか）は EditMesh::setTwins が確かめる
+    if (h.twinCount != 0 && h.twinCount != h.faceIndexCount)
+        throw std::runtime_error(std::string("mesh_cache: twin count mismatch ") + path);
+    m_polygons.twins = section<uint32_t>(m_file, h.twinByteOffset, h.twinCount);
+    m_polygons.edgeCount = h.edgeCount;
+}
+
+glm::vec3 mesh_cache::View::boundsMin() const
+{
+    return glm::vec3(m_header->boundsMin[0], m_header->boundsMin[1], m_header->boundsMin[2]);
+}
+
+glm::vec3 mesh_cache::View::boundsMax() const
+{
+    return glm::vec3(m_header->boundsMax[0], m_header->boundsMax[1], m_header->boundsMax[2]);
+}
+
+bool mesh_cache::isUpToDate(const char* cachePath, const char* sourcePath)
+{
+    std::error_code ec;
+    const auto cacheTime = std::filesystem::last_write_time(cachePath, ec);
+    if (ec) return false;
+    const auto sourceTime = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec) return false;
+    return cacheTime >= sourceTime;
+}
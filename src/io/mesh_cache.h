@@ -0,0 +1,129 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+#include "vector"
+
+#include "glm/glm.hpp"
+
+#include "io/mapped_file.h"
+#include "render/vertex.h"
+
+/**
+ * @brief 描画用メッシュのネイティブバイナリキャッシュ（.aqm）
+ *
+ * OBJ の再解析を省くため、Mesh が保持するデータをそのままの形で書き出す。
+ *
+ *   [Header][Vertex x N][uint32 index x M][vec3 normal x N][vec2 uv x N][vec3 x P][uint32 faceSize x F][uint32 faceIndex x C][uint32 twin x C]
+ *
+ * - 各区画は 16 バイト境界に整列し、オフセットは Header に記録する
+ * - 頂点は Vertex の生のメモリ配置。stride とメンバ位置を Header に持ち、
+ *   読み込み時に現在のビルドと一致しなければ拒否する（形式変更時は kVersion を上げる）
+ * - 法線・UV 区画（圧縮頂点形式へ変換するときに使う）と多角形区画（EditMesh 用）は省略可
+ * - twin 区画は多角形区画の半辺ごとの EditMesh::twin。あれば読み込み時に buildTwins() のソートを省ける
+ *
+ * 読み込みはメモリマップのみで、頂点・インデックスは span として返す。
+ * Mesh::upload にそのまま渡せば中間の std::vector を経由しない。
+ * 不正・非互換なファイル（区画がはみ出す・インデックスが頂点数を超えるなど）は std::runtime_error。
+ */
+namespace mesh_cache
+{
+    constexpr uint32_t kMagic = 0x434D5141u; // "AQMC"（リトルエンディアン）
+    constexpr uint32_t kVersion = 3;    ///< 2: 法線・UV 区画、3: twin 区画
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vertexStride;
+        uint32_t positionOffset;         ///< offsetof(Vertex, position)
+        uint32_t colorOffset;            ///< offsetof(Vertex, color)
+        uint32_t edgeCount;              ///< EditMesh::edgeCount（twin 区画があるとき）
+
+        uint64_t vertexCount;
+        uint64_t indexCount;
+        uint64_t normalCount;            ///< 0 か vertexCount
+        uint64_t texcoordCount;          ///< 0 か vertexCount
+        uint64_t positionCount;          ///< 多角形区画（0 なら無し）
+        uint64_t faceCount;
+        uint64_t faceIndexCount;
+        uint64_t twinCount;              ///< 0 か faceIndexCount
+
+        uint64_t vertexByteOffset;
+        uint64_t indexByteOffset;
+        uint64_t normalByteOffset;
+        uint64_t texcoordByteOffset;
+        uint64_t positionByteOffset;
+        uint64_t faceSizeByteOffset;
+        uint64_t faceIndexByteOffset;
+        uint64_t twinByteOffset;
+
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    /// 多角形区画（EditMesh を組み立てるための元データ）
+    struct PolygonData
+    {
+        std::span<const glm::vec3> positions;
+        std::span<const uint32_t>  faceSizes;
+        std::span<const uint32_t>  faceIndices;
+        std::span<const uint32_t>  twins;       ///< EditMesh::halfEdgeTwin（空なら読み込み側で解決する）
+        uint32_t edgeCount = 0;                 ///< twins があるときの EditMesh::edgeCount
+    };
+
+    /// 頂点と同じ並びの法線・UV（ObjMeshData::vertexNormals / vertexTexcoords。無ければ空）
+    struct AttributeData
+    {
+        std::span<const glm::vec3> normals;
+        std::span<const glm::vec2> texcoords;
+    };
+
+    /**
+     * @brief キャッシュを書き出す
+     *
+     * 一時ファイルに書いてから置き換えるので、途中で失敗しても既存のキャッシュは壊れない。
+     */
+    void save(const char* path,
+        std::span<const Vertex> vertices,
+        std::span<const uint32_t> indices,
+        const PolygonData* polygons = nullptr,
+        const AttributeData* attributes = nullptr);
+
+    /**
+     * @brief メモリマップしたキャッシュ
+     *
+     * 返す span はすべてマップ領域を直接指す。このオブジェクトより長く使わないこと。
+     */
+    class View
+    {
+    public:
+        View() = default;
+        explicit View(const char* path);
+
+        const Header& header() const { return *m_header; }
+
+        std::span<const Vertex> vertices() const { return m_vertices; }
+        std::span<const uint32_t> indices() const { return m_indices; }
+        std::span<const glm::vec3> normals() const { return m_attributes.normals; }
+        std::span<const glm::vec2> texcoords() const { return m_attributes.texcoords; }
+
+        bool hasPolygons() const { return !m_polygons.faceSizes.empty(); }
+        const PolygonData& polygons() const { return m_polygons; }
+
+        glm::vec3 boundsMin() const;
+        glm::vec3 boundsMax() const;
+
+    private:
+        MappedFile m_file;
+        const Header* m_header = nullptr;
+
+        std::span<const Vertex>   m_vertices;
+        std::span<const uint32_t> m_indices;
+        AttributeData m_attributes;
+        PolygonData m_polygons;
+    };
+
+    /// cachePath が存在し、sourcePath 以降に更新されていれば true
+    bool isUpToDate(const char* cachePath, const char* sourcePath);
+}
@@ -0,0 +1,326 @@
+#include "io/mesh_exporter.h"
+
+#include "algorithm"
+#include "bit"
+#include "charconv"
+#include "condition_variable"
+#include "cstdio"
+#include "cstring"
+#include "exception"
+#include "filesystem"
+#include "mutex"
+#include "stdexcept"
+#include "string"
+#include "system_error"
+#include "thread"
+
+namespace
+{
+    constexpr size_t kRecordsPerChunk = 1u << 16;
+
+    // 1 レコードあたりの最大バイト数（テキスト）
+    // float の最短表現は符号・指数込みで 15 文字以内、uint32 は 10 桁
+    constexpr size_t kMaxFloatChars = 16;
+    constexpr size_t kMaxIndexChars = 11;
+
+    struct ChunkRange
+    {
+        bool   faces;
+        size_t begin, end;      ///< 頂点番号または面番号
+    };
+
+    char* putFloat(char* p, char* end, float v)
+    {
+        return std::to_chars(p, end, v).ptr;
+    }
+
+    char* putIndex(char* p, char* end, uint32_t v)
+    {
+        return std::to_chars(p, end, v).ptr;
+    }
+
+    template <class T>
+    char* putRaw(char* p, const T& v)
+    {
+        std::memcpy(p, &v, sizeof(T));
+        return p + sizeof(T);
+    }
+
+    /**
+     * 順序付きパイプライン
+     *
+     * ワーカーがチャンク番号を取り合って format(chunk, buf) で整形し、
+     * 呼び出しスレッドが番号順に write(buf) する。
+     * 未書き込みのチャンクは window 個まで。
+     */
+    template <class FormatFn, class WriteFn>
+    void orderedPipeline(size_t chunkCount, unsigned threadCount,
+        FormatFn&& format, WriteFn&& write, ExportProgress* progress)
+    {
+        const size_t window = (size_t)threadCount * 2;
+
+        struct Slot
+        {
+            std::vector<char> data;
+            size_t chunk = SIZE_MAX;     ///< 整形済みのチャンク番号
+        };
+        std::vector<Slot> slots(window);
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t nextChunk = 0;
+        size_t written = 0;
+        bool abort = false;
+        std::exception_ptr error;
+
+        auto fail = [&](std::exception_ptr e)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = e;
+                abort = true;
+                cv.notify_all();
+            };
+
+        auto worker = [&]
+            {
+                for (;;)
+                {
+                    size_t chunk;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        if (abort || nextChunk >= chunkCount) return;
+                        chunk = nextChunk++;
+                        cv.wait(lock, [&] { return abort || chunk < written + window; });
+                        if (abort) return;
+                    }
+
+                    Slot& slot = slots[chunk % window];
+                    try
+                    {
+                        format(chunk, slot.data);
+                    }
+                    catch (...)
+                    {
+                        fail(std::current_exception());
+                        return;
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    slot.chunk = chunk;
+                    cv.notify_all();
+                }
+            };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (unsigned i = 0; i < threadCount; ++i)
+            threads.emplace_back(worker);
+
+        try
+        {
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                Slot& slot = slots[chunk % window];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return abort || slot.chunk == chunk; });
+                    if (abort) break;
+                }
+
+                // slot はこのチャンクが書き終わるまでワーカーに再利用されない
+                write(slot.data, chunk);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                ++written;
+                if (progress && progress->cancel.load(std::memory_order_relaxed))
+                {
+                    if (!error) error = std::make_exception_ptr(std::runtime_error("export cancelled"));
+                    abort = true;
+                }
+                cv.notify_all();
+            }
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
+
+        for (std::thread& t : threads) t.join();
+        if (error) std::rethrow_exception(error);
+    }
+
+    std::string plyHeader(size_t vertexCount, size_t faceCount)
+    {
+        const char* endian = (std::endian::native == std::endian::little)
+            ? "binary_little_endian" : "binary_big_endian";
+
+        std::string h;
+        h += "ply\nformat ";
+        h += endian;
+        h += " 1.0\ncomment aquamarine\nelement vertex ";
+        h += std::to_string(vertexCount);
+        h += "\nproperty float x\nproperty float y\nproperty float z\nelement face ";
+        h += std::to_string(faceCount);
+        h += "\nproperty list uchar uint vertex_indices\nend_header\n";
+        return h;
+    }
+}
+
+ExportMesh ExportMesh::fromEditMesh(const EditMesh& mesh)
+{
+    ExportMesh out;
+    out.positions = mesh.positions();
+
+    out.faceSizes.reserve(mesh.faceCount());
+    out.faceIndices.reserve(mesh.halfEdgeCount());
+    for (uint32_t f = 0; f < mesh.faceCount(); ++f)
+    {
+        out.faceSizes.push_back(mesh.faceDegree(f));
+        mesh.forEachFaceVertex(f, [&](uint32_t v) { out.faceIndices.push_back(v); });
+    }
+    return out;
+}
+
+void mesh_exporter::write(const char* path, ExportFormat format,
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> faceSizes,
+    std::span<const uint32_t> faceIndices,
+    ExportProgress* progress,
+    unsigned threadCount)
+{
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    // 面ごとの先頭コーナー（チャンク単位で独立に整形するため）
+    std::vector<size_t> faceFirst(faceSizes.size() + 1);
+    for (size_t f = 0; f < faceSizes.size(); ++f)
+    {
+        if (format == ExportFormat::PlyBinary && faceSizes[f] > 255)
+            throw std::runtime_error("mesh_exporter: PLY face has more than 255 vertices");
+        faceFirst[f + 1] = faceFirst[f] + faceSizes[f];
+    }
+    if (faceFirst.back() != faceIndices.size())
+        throw std::runtime_error("mesh_exporter: face indices do not match face sizes");
+
+    std::vector<ChunkRange> chunks;
+    for (size_t i = 0; i < positions.size(); i += kRecordsPerChunk)
+        chunks.push_back({ false, i, std::min(positions.size(), i + kRecordsPerChunk) });
+    for (size_t i = 0; i < faceSizes.size(); i += kRecordsPerChunk)
+        chunks.push_back({ true, i, std::min(faceSizes.size(), i + kRecordsPerChunk) });
+
+    if (progress)
+    {
+        progress->total = positions.size() + faceSizes.size();
+        progress->done = 0;
+    }
+
+    auto formatChunk = [&](size_t index, std::vector<char>& buf)
+        {
+            const ChunkRange& c = chunks[index];
+            const size_t records = c.end - c.begin;
+            const size_t corners = c.faces ? faceFirst[c.end] - faceFirst[c.begin] : 0;
+
+            if (format == ExportFormat::Obj)
+            {
+                // "v x y z\n" / "f a b c ...\n"
+                buf.resize(c.faces ? records * 3 + corners * kMaxIndexChars : records * (5 + 3 * kMaxFloatChars));
+                char* p = buf.data();
+                char* const end = p + buf.size();
+
+                if (!c.faces)
+                {
+                    for (size_t v = c.begin; v < c.end; ++v)
+                    {
+                        const glm::vec3& pos = positions[v];
+                        *p++ = 'v';
+                        *p++ = ' '; p = putFloat(p, end, pos.x);
+                        *p++ = ' '; p = putFloat(p, end, pos.y);
+                        *p++ = ' '; p = putFloat(p, end, pos.z);
+                        *p++ = '\n';
+                    }
+                }
+                else
+                {
+                    for (size_t f = c.begin; f < c.end; ++f)
+                    {
+                        *p++ = 'f';
+                        for (size_t i = faceFirst[f]; i < faceFirst[f + 1]; ++i)
+                        {
+                            *p++ = ' ';
+                            p = putIndex(p, end, faceIndices[i] + 1);
+                        }
+                        *p++ = '\n';
+                    }
+                }
+                buf.resize((size_t)(p - buf.data()));
+            }
+            else
+            {
+                if (!c.faces)
+                {
+                    // glm::vec3 は float 3 個の詰め配置なのでそのまま並べる
+                    buf.resize(records * sizeof(glm::vec3));
+                    std::memcpy(buf.data(), positions.data() + c.begin, buf.size());
+                }
+                else
+                {
+                    buf.resize(records + corners * sizeof(uint32_t));
+                    char* p = buf.data();
+                    for (size_t f = c.begin; f < c.end; ++f)
+                    {
+                        *p++ = (char)(uint8_t)faceSizes[f];
+                        const size_t bytes = (size_t)faceSizes[f] * sizeof(uint32_t);
+                        std::memcpy(p, faceIndices.data() + faceFirst[f], bytes);
+                        p += bytes;
+                    }
+                }
+            }
+        };
+
+    const std::string tmpPath = std::string(path) + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (!file) throw std::runtime_error(std::string("mesh_exporter: cannot write ") + tmpPath);
+
+    // チャンクは数 MB 単位で fwrite するので、stdio のバッファは小さな書き込みをまとめる分だけでよい
+    std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    try
+    {
+        if (format == ExportFormat::Obj)
+        {
+            const char header[] = "# aquamarine\n";
+            std::fwrite(header, 1, sizeof(header) - 1, file);
+        }
+        else
+        {
+            const std::string header = plyHeader(positions.size(), faceSizes.size());
+            std::fwrite(header.data(), 1, header.size(), file);
+        }
+
+        orderedPipeline(chunks.size(), threadCount, formatChunk,
+            [&](const std::vector<char>& buf, size_t index)
+            {
+                if (std::fwrite(buf.data(), 1, buf.size(), file) != buf.size())
+                    throw std::runtime_error(std::string("mesh_exporter: write failed ") + tmpPath);
+                if (progress)
+                    progress->done += chunks[index].end - chunks[index].begin;
+            },
+            progress);
+
+        if (std::fclose(file) != 0)
+        {
+            file = nullptr;
+            throw std::runtime_error(std::string("mesh_exporter: write failed ") + tmpPath);
+        }
+        file = nullptr;
+
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) throw std::runtime_error(std::string("mesh_exporter: cannot replace ") + path);
+    }
+    catch (...)
+    {
+        if (file) std::fclose(file);
+        std::remove(tmpPath.c_str());
+        throw;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "atomic"
+#include "cstdint"
+#include "span"
+#include "vector"
+
+#include "glm/glm.hpp"
+
+#include "mesh/edit_mesh.h"
+
+enum class ExportFormat
+{
+    Obj,
+    PlyBinary,
+};
+
+/// 書き出し対象の多角形メッシュ（バックグラウンドで使うため EditMesh から複製しておく）
+struct ExportMesh
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t>  faceSizes;
+    std::vector<uint32_t>  faceIndices;
+
+    static ExportMesh fromEditMesh(const EditMesh& mesh);
+};
+
+/// 別スレッドから読む進捗。cancel を立てると次のチャンク境界で中断する
+struct ExportProgress
+{
+    std::atomic<uint64_t> done{ 0 };     ///< 書き出し済みレコード数（頂点 + 面）
+    std::atomic<uint64_t> total{ 0 };
+    std::atomic<bool>     cancel{ false };
+};
+
+/**
+ * @brief OBJ / バイナリ PLY の書き出し
+ *
+ * 頂点・面レコードを一定数ごとのチャンクに分け、複数スレッドで並列に
+ * テキスト化（std::to_chars）またはバイナリ化する。
+ * 書き込みは呼び出しスレッドがチャンク順に大きな fwrite で行う。
+ * 整形済みで未書き込みのチャンクはスレッド数の 2 倍までに抑えるので、
+ * メッシュの大きさに関わらずメモリ使用量は一定。
+ *
+ * 書き出しは一時ファイルに行い、完了後に置き換える。
+ * 失敗・中断時は std::runtime_error（一時ファイルは削除）。
+ * バイナリ PLY は実行環境のバイトオーダーで書き、ヘッダにそれを記す。
+ */
+namespace mesh_exporter
+{
+    void write(const char* path, ExportFormat format,
+        std::span<const glm::vec3> positions,
+        std::span<const uint32_t> faceSizes,
+        std::span<const uint32_t> faceIndices,
+        ExportProgress* progress = nullptr,
+        unsigned threadCount = 0);
+
+    inline void write(const char* path, ExportFormat format, const ExportMesh& mesh,
+        ExportProgress* progress = nullptr, unsigned threadCount = 0)
+    {
+        write(path, format, mesh.positions, mesh.faceSizes, mesh.faceIndices, progress, threadCount);
+    }
+}
@@ -0,0 +1,451 @@
+#include "io/obj_importer.h"
+
+#include "algorithm"
+#include "charconv"
+#include "cstring"
+#include "stdexcept"
+#include "string"
+#include "thread"
+
+#include "io/mapped_file.h"
+
+namespace
+{
+    constexpr uint32_t kNone = 0xFFFFFFFFu;
+    const glm::vec4 kDefaultColor(0.35f, 0.35f, 0.35f, 1.0f);
+
+    struct Corner
+    {
+        uint32_t v, vt, vn;
+    };
+
+    struct Chunk
+    {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+
+        // 1) で数える
+        size_t positionCount = 0, texcoordCount = 0, normalCount = 0, faceCount = 0;
+
+        // 累積オフセット
+        size_t positionBase = 0, texcoordBase = 0, normalBase = 0;
+
+        // 2) の結果
+        std::vector<Corner>   corners;
+        std::vector<uint32_t> faceSizes;
+        size_t triangleCount = 0;
+        bool   hasColor = false;
+
+        std::string error;
+    };
+
+    bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    const char* skipSpace(const char* p, const char* end)
+    {
+        while (p < end && isSpace(*p)) ++p;
+        return p;
+    }
+
+    const char* nextLine(const char* p, const char* end)
+    {
+        const void* nl = std::memchr(p, '\n', (size_t)(end - p));
+        return nl ? static_cast<const char*>(nl) + 1 : end;
+    }
+
+    // 先頭の識別子（"v", "vt", "vn", "f"）を判定する
+    enum class LineKind { Other, Position, Texcoord, Normal, Face };
+
+    LineKind classify(const char* p, const char* end)
+    {
+        if (end - p < 2) return LineKind::Other;
+        if (p[0] == 'v')
+        {
+            if (isSpace(p[1])) return LineKind::Position;
+            if (end - p >= 3 && isSpace(p[2]))
+            {
+                if (p[1] == 't') return LineKind::Texcoord;
+                if (p[1] == 'n') return LineKind::Normal;
+            }
+            return LineKind::Other;
+        }
+        if (p[0] == 'f' && isSpace(p[1])) return LineKind::Face;
+        return LineKind::Other;
+    }
+
+    const char* parseFloat(const char* p, const char* end, float& out)
+    {
+        p = skipSpace(p, end);
+        if (p < end && *p == '+') ++p;
+        auto [ptr, ec] = std::from_chars(p, end, out);
+        return (ec == std::errc()) ? ptr : nullptr;
+    }
+
+    // OBJ インデックス（1 始まり / 負は末尾から）を 0 始まりの絶対番号へ
+    bool resolveIndex(long long idx, size_t countSoFar, uint32_t& out)
+    {
+        if (idx > 0) { out = (uint32_t)(idx - 1); return true; }
+        if (idx < 0 && (size_t)(-idx) <= countSoFar) { out = (uint32_t)(countSoFar + idx); return true; }
+        return false;
+    }
+
+    void countChunk(Chunk& c)
+    {
+        for (const char* p = c.begin; p < c.end; p = nextLine(p, c.end))
+        {
+            switch (classify(skipSpace(p, c.end), c.end))
+            {
+            case LineKind::Position: ++c.positionCount; break;
+            case LineKind::Texcoord: ++c.texcoordCount; break;
+            case LineKind::Normal:   ++c.normalCount; break;
+            case LineKind::Face:     ++c.faceCount; break;
+            default: break;
+            }
+        }
+    }
+
+    void parseChunk(Chunk& c, ObjMeshData& out, std::vector<glm::vec4>& colors)
+    {
+        size_t vi = c.positionBase, ti = c.texcoordBase, ni = c.normalBase;
+
+        c.faceSizes.reserve(c.faceCount);
+        c.corners.reserve(c.faceCount * 4);
+
+        for (const char* line = c.begin; line < c.end;)
+        {
+            const char* eol = nextLine(line, c.end);
+            const char* p = skipSpace(line, eol);
+            const LineKind kind = classify(p, eol);
+            line = eol;
+
+            switch (kind)
+            {
+            case LineKind::Position:
+            {
+                glm::vec3 v;
+                p += 1;
+                for (int k = 0; k < 3 && p; ++k) p = parseFloat(p, eol, v[k]);
+                if (!p) { c.error = "invalid 'v' line"; return; }
+                out.positions[vi] = v;
+
+                // 頂点色（任意）
+                glm::vec4 col = kDefaultColor;
+                const char* q = p;
+                for (int k = 0; k < 3 && q; ++k) q = parseFloat(q, eol, col[k]);
+                if (q)
+                {
+                    colors[vi] = col;
+                    c.hasColor = true;
+                }
+                ++vi;
+                break;
+            }
+            case LineKind::Texcoord:
+            {
+                glm::vec2 t;
+                p += 2;
+                for (int k = 0; k < 2 && p; ++k) p = parseFloat(p, eol, t[k]);
+                if (!p) { c.error = "invalid 'vt' line"; return; }
+                out.texcoords[ti++] = t;
+                break;
+            }
+            case LineKind::Normal:
+            {
+                glm::vec3 n;
+                p += 2;
+                for (int k = 0; k < 3 && p; ++k) p = parseFloat(p, eol, n[k]);
+                if (!p) { c.error = "invalid 'vn' line"; return; }
+                out.normals[ni++] = n;
+                break;
+            }
+            case LineKind::Face:
+            {
+                uint32_t n = 0;
+                p += 1;
+                for (;;)
+                {
+                    p = skipSpace(p, eol);
+                    if (p >= eol || *p == '\n' || *p == '#') break;
+
+                    Corner corner{ kNone, kNone, kNone };
+                    long long idx = 0;
+
+                    auto r = std::from_chars(p, eol, idx);
+                    if (r.ec != std::errc() || !resolveIndex(idx, vi, corner.v)) { c.error = "invalid 'f' index"; return; }
+                    p = r.ptr;
+
+                    if (p < eol && *p == '/')
+                    {
+                        ++p;
+                        if (p < eol && *p != '/')
+                        {
+                            r = std::from_chars(p, eol, idx);
+                            if (r.ec != std::errc() || !resolveIndex(idx, ti, corner.vt)) { c.error = "invalid 'f' texcoord index"; return; }
+                            p = r.ptr;
+                        }
+                        if (p < eol && *p == '/')
+                        {
+                            ++p;
+                            r = std::from_chars(p, eol, idx);
+                            if (r.ec != std::errc() || !resolveIndex(idx, ni, corner.vn)) { c.error = "invalid 'f' normal index"; return; }
+                            p = r.ptr;
+                        }
+                    }
+
+                    c.corners.push_back(corner);
+                    ++n;
+                }
+
+                if (n < 3) { c.error = "face with fewer than 3 vertices"; return; }
+                c.faceSizes.push_back(n);
+                c.triangleCount += n - 2;
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    // index を n 個に分けて並列実行する
+    template <class Fn>
+    void parallelFor(size_t n, Fn&& fn)
+    {
+        if (n <= 1)
+        {
+            for (size_t i = 0; i < n; ++i) fn(i);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(n - 1);
+        for (size_t i = 1; i < n; ++i)
+            threads.emplace_back([&fn, i] { fn(i); });
+        fn(0);
+        for (std::thread& t : threads) t.join();
+    }
+
+    // (v, vt, vn) → 頂点番号のオープンアドレス法ハッシュ表
+    class CornerTable
+    {
+    public:
+        explicit CornerTable(size_t expected)
+        {
+            size_t cap = 16;
+            while (cap < expected * 2) cap <<= 1;
+            m_keys.assign(cap, Corner{ kNone, kNone, kNone });
+            m_values.resize(cap);
+            m_mask = cap - 1;
+        }
+
+        // 見つからなければ value を登録して true
+        bool insert(const Corner& k, uint32_t value, uint32_t& found)
+        {
+            size_t h = (k.v * 0x9E3779B1u) ^ (k.vt * 0x85EBCA77u) ^ (k.vn * 0xC2B2AE3Du);
+            h ^= h >> 15;
+            for (size_t i = h & m_mask;; i = (i + 1) & m_mask)
+            {
+                Corner& slot = m_keys[i];
+                if (slot.v == kNone)
+                {
+                    slot = k;
+                    m_values[i] = value;
+                    found = value;
+                    return true;
+                }
+                if (slot.v == k.v && slot.vt == k.vt && slot.vn == k.vn)
+                {
+                    found = m_values[i];
+                    return false;
+                }
+            }
+        }
+
+    private:
+        std::vector<Corner>   m_keys;
+        std::vector<uint32_t> m_values;
+        size_t m_mask = 0;
+    };
+}
+
+ObjMeshData obj_importer::load(const char* path, unsigned threadCount)
+{
+    MappedFile file(path);
+    try
+    {
+        return parse(file.view(), threadCount);
+    }
+    catch (const std::runtime_error& e)
+    {
+        throw std::runtime_error(std::string(path) + ": " + e.what());
+    }
+}
+
+ObjMeshData obj_importer::parse(std::string_view text, unsigned threadCount)
+{
+    ObjMeshData out;
+    if (text.empty()) return out;
+
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    // 1 スレッドあたり最低 1MB 程度は持たせる
+    constexpr size_t kMinChunkBytes = 1u << 20;
+    const size_t chunkCount = std::clamp<size_t>(text.size() / kMinChunkBytes, 1, threadCount);
+
+    // ---- 0) 行頭でチャンクに分割 ----
+    std::vector<Chunk> chunks(chunkCount);
+    const char* const begin = text.data();
+    const char* const end = begin + text.size();
+    const char* cursor = begin;
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        chunks[i].begin = cursor;
+        if (i + 1 == chunkCount)
+        {
+            cursor = end;
+        }
+        else
+        {
+            const char* target = std::max(cursor, begin + text.size() * (i + 1) / chunkCount);
+            cursor = (target < end) ? nextLine(target, end) : end;
+        }
+        chunks[i].end = cursor;
+    }
+
+    // ---- 1) 行数を数えて出力先を確保 ----
+    parallelFor(chunkCount, [&](size_t i) { countChunk(chunks[i]); });
+
+    size_t positionCount = 0, texcoordCount = 0, normalCount = 0;
+    for (Chunk& c : chunks)
+    {
+        c.positionBase = positionCount;
+        c.texcoordBase = texcoordCount;
+        c.normalBase = normalCount;
+        positionCount += c.positionCount;
+        texcoordCount += c.texcoordCount;
+        normalCount += c.normalCount;
+    }
+    if (positionCount >= kNone) throw std::runtime_error("too many vertices");
+
+    out.positions.resize(positionCount);
+    out.texcoords.resize(texcoordCount);
+    out.normals.resize(normalCount);
+    std::vector<glm::vec4> colors(positionCount, kDefaultColor);
+
+    // ---- 2) 並列に解析し、最終配列へ直接書く ----
+    parallelFor(chunkCount, [&](size_t i) { parseChunk(chunks[i], out, colors); });
+
+    size_t cornerCount = 0, faceCount = 0, triangleCount = 0;
+    bool hasAttributes = false;
+    for (const Chunk& c : chunks)
+    {
+        if (!c.error.empty()) throw std::runtime_error(c.error);
+        cornerCount += c.corners.size();
+        faceCount += c.faceSizes.size();
+        triangleCount += c.triangleCount;
+    }
+
+    // 範囲外参照は全体の個数が分かってからまとめて検査する
+    for (const Chunk& c : chunks)
+    {
+        for (const Corner& k : c.corners)
+        {
+            if (k.v >= positionCount ||
+                (k.vt != kNone && k.vt >= texcoordCount) ||
+                (k.vn != kNone && k.vn >= normalCount))
+                throw std::runtime_error("face index out of range");
+            hasAttributes |= (k.vt != kNone || k.vn != kNone);
+        }
+    }
+
+    // 多角形（位置インデックス）
+    out.faceSizes.reserve(faceCount);
+    out.faceIndices.reserve(cornerCount);
+    for (const Chunk& c : chunks)
+    {
+        out.faceSizes.insert(out.faceSizes.end(), c.faceSizes.begin(), c.faceSizes.end());
+        for (const Corner& k : c.corners) out.faceIndices.push_back(k.v);
+    }
+
+    // ---- 3) 頂点の重複排除と三角形化 ----
+    out.indices.resize(triangleCount * 3);
+
+    if (!hasAttributes)
+    {
+        // v のみ：位置 = 頂点。チャンクごとに書き込み先が決まるので並列
+        out.vertices.resize(positionCount);
+        parallelFor(chunkCount, [&](size_t i)
+            {
+                const size_t from = chunks[i].positionBase;
+                for (size_t k = 0; k < chunks[i].positionCount; ++k)
+                    out.vertices[from + k] = { out.positions[from + k], colors[from + k] };
+            });
+
+        std::vector<size_t> indexBase(chunkCount, 0);
+        for (size_t i = 1; i < chunkCount; ++i)
+            indexBase[i] = indexBase[i - 1] + chunks[i - 1].triangleCount * 3;
+
+        parallelFor(chunkCount, [&](size_t i)
+            {
+                const Chunk& c = chunks[i];
+                uint32_t* dst = out.indices.data() + indexBase[i];
+                size_t corner = 0;
+                for (uint32_t n : c.faceSizes)
+                {
+                    const Corner* f = c.corners.data() + corner;
+                    for (uint32_t k = 1; k + 1 < n; ++k)
+                    {
+                        *dst++ = f[0].v;
+                        *dst++ = f[k].v;
+                        *dst++ = f[k + 1].v;
+                    }
+                    corner += n;
+                }
+            });
+        return out;
+    }
+
+    CornerTable table(cornerCount);
+    out.vertices.reserve(positionCount);
+    if (normalCount > 0) out.vertexNormals.reserve(positionCount);
+    if (texcoordCount > 0) out.vertexTexcoords.reserve(positionCount);
+
+    std::vector<uint32_t> remap;
+    size_t dst = 0;
+    for (const Chunk& c : chunks)
+    {
+        remap.resize(c.corners.size());
+        for (size_t k = 0; k < c.corners.size(); ++k)
+        {
+            const Corner& key = c.corners[k];
+            uint32_t index = 0;
+            if (table.insert(key, (uint32_t)out.vertices.size(), index))
+            {
+                out.vertices.push_back({ out.positions[key.v], colors[key.v] });
+                if (normalCount > 0)
+                    out.vertexNormals.push_back(key.vn != kNone ? out.normals[key.vn] : glm::vec3(0.0f));
+                if (texcoordCount > 0)
+                    out.vertexTexcoords.push_back(key.vt != kNone ? out.texcoords[key.vt] : glm::vec2(0.0f));
+            }
+            remap[k] = index;
+        }
+
+        size_t corner = 0;
+        for (uint32_t n : c.faceSizes)
+        {
+            for (uint32_t k = 1; k + 1 < n; ++k)
+            {
+                out.indices[dst++] = remap[corner];
+                out.indices[dst++] = remap[corner + k];
+                out.indices[dst++] = remap[corner + k + 1];
+            }
+            corner += n;
+        }
+    }
+    return out;
+}
+
+EditMesh obj_importer::buildEditMesh(const ObjMeshData& obj)
+{
+    return EditMesh::fromPolygons(obj.positions, obj.faceSizes, obj.faceIndices);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "cstdint"
+#include "string_view"
+#include "vector"
+
+#include "glm/glm.hpp"
+
+#include "mesh/edit_mesh.h"
+#include "render/vertex.h"
+
+struct ObjMeshData
+{
+    // GPU 用：v/vt/vn の組ごとに 1 頂点、多角形はファン分割した三角形
+    std::vector<Vertex>   vertices;
+    std::vector<uint32_t> indices;
+
+    // vertices と同じ並びの法線・UV（ファイルに vn / vt が無ければ空。欠けた角は 0）
+    // 圧縮頂点形式（vertex_pack）へ変換するときに使う
+    std::vector<glm::vec3> vertexNormals;
+    std::vector<glm::vec2> vertexTexcoords;
+
+    // 元データ
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texcoords;
+    std::vector<glm::vec3> normals;
+
+    // 多角形（位置インデックス、EditMesh 用）
+    std::vector<uint32_t> faceSizes;
+    std::vector<uint32_t> faceIndices;
+};
+
+/**
+ * @brief Wavefront OBJ の読み込み
+ *
+ * ファイルはメモリマップし、行頭で区切ったチャンクを複数スレッドで並列に解析する。
+ * 1) 各チャンクの v / vt / vn / f 行を数える（並列）
+ * 2) 累積オフセットが決まるので、各チャンクが最終配列へ直接書き込む（並列）
+ *    負のインデックス（相対参照）もこの時点で絶対番号に解決できる
+ * 3) v/vt/vn の組をハッシュ表で重複排除して頂点・インデックスを作る
+ *    vt / vn が無いファイルは位置をそのまま頂点にする（並列）
+ *
+ * 数値は std::from_chars で読む。`v x y z r g b` の頂点色拡張にも対応。
+ * 不正な行・範囲外インデックスは std::runtime_error。
+ */
+namespace obj_importer
+{
+    ObjMeshData load(const char* path, unsigned threadCount = 0);
+    ObjMeshData parse(std::string_view text, unsigned threadCount = 0);
+
+    EditMesh buildEditMesh(const ObjMeshData& obj);
+}
@@ -0,0 +1,317 @@
+#include "mesh/bvh.h"
+
+#include "algorithm"
+#include "cfloat"
+#include "utility"
+
+namespace
+{
+    constexpr int      kBinCount = 16;
+    constexpr uint32_t kMaxLeafSize = 8;
+    constexpr uint32_t kInlineStackSize = 64;
+
+    /// 走査用スタック。普通は固定長の配列で足り、溢れた分だけヒープへ積む（部分木を取りこぼさない）
+    class TraversalStack
+    {
+    public:
+        bool empty() const { return m_size == 0; }
+
+        void push(uint32_t node)
+        {
+            if (m_size < kInlineStackSize) m_inline[m_size] = node;
+            else m_overflow.push_back(node);
+            ++m_size;
+        }
+
+        uint32_t pop()
+        {
+            --m_size;
+            if (m_size < kInlineStackSize) return m_inline[m_size];
+            const uint32_t node = m_overflow.back();
+            m_overflow.pop_back();
+            return node;
+        }
+
+    private:
+        uint32_t m_inline[kInlineStackSize];
+        uint32_t m_size = 0;
+        std::vector<uint32_t> m_overflow;
+    };
+
+    struct Bounds
+    {
+        glm::vec3 bmin{ FLT_MAX };
+        glm::vec3 bmax{ -FLT_MAX };
+
+        void grow(const glm::vec3& p) { bmin = glm::min(bmin, p); bmax = glm::max(bmax, p); }
+        void grow(const Bounds& b) { bmin = glm::min(bmin, b.bmin); bmax = glm::max(bmax, b.bmax); }
+
+        float area() const
+        {
+            const glm::vec3 e = bmax - bmin;
+            if (e.x < 0.0f) return 0.0f;
+            return e.x * e.y + e.y * e.z + e.z * e.x;
+        }
+    };
+
+    struct Bin
+    {
+        Bounds   bounds;
+        uint32_t count = 0;
+    };
+
+    // スラブ法。ヒットしなければ FLT_MAX
+    float intersectAabb(const glm::vec3& bmin, const glm::vec3& bmax,
+        const glm::vec3& origin, const glm::vec3& invDir, float tMax)
+    {
+        const glm::vec3 t0 = (bmin - origin) * invDir;
+        const glm::vec3 t1 = (bmax - origin) * invDir;
+        const glm::vec3 tn = glm::min(t0, t1);
+        const glm::vec3 tf = glm::max(t0, t1);
+
+        const float tNear = std::max(std::max(tn.x, tn.y), std::max(tn.z, 0.0f));
+        const float tFar = std::min(std::min(tf.x, tf.y), std::min(tf.z, tMax));
+        return (tNear <= tFar) ? tNear : FLT_MAX;
+    }
+}
+
+void TriangleBvh::clear()
+{
+    m_nodes.clear();
+    m_v0.clear();
+    m_e1.clear();
+    m_e2.clear();
+    m_faceId.clear();
+}
+
+void TriangleBvh::build(const EditMesh& mesh)
+{
+    clear();
+
+    // ---- 1) ファン分割した三角形を集める ----
+    std::vector<glm::vec3> a, b, c;
+    std::vector<uint32_t> faceId;
+    a.reserve(mesh.halfEdgeCount());
+    b.reserve(mesh.halfEdgeCount());
+    c.reserve(mesh.halfEdgeCount());
+    faceId.reserve(mesh.halfEdgeCount());
+
+    for (uint32_t f = 0; f < mesh.faceCount(); ++f)
+    {
+        const uint32_t he0 = mesh.faceHalfEdge(f);
+        const glm::vec3& p0 = mesh.position(mesh.vertex(he0));
+
+        for (uint32_t he = mesh.next(he0); mesh.next(he) != he0; he = mesh.next(he))
+        {
+            a.push_back(p0);
+            b.push_back(mesh.position(mesh.vertex(he)));
+            c.push_back(mesh.position(mesh.destVertex(he)));
+            faceId.push_back(f + 1);
+        }
+    }
+
+    const uint32_t triCount = (uint32_t)faceId.size();
+    if (triCount == 0) return;
+
+    std::vector<Bounds> triBounds(triCount);
+    std::vector<glm::vec3> centroid(triCount);
+    for (uint32_t i = 0; i < triCount; ++i)
+    {
+        triBounds[i].grow(a[i]);
+        triBounds[i].grow(b[i]);
+        triBounds[i].grow(c[i]);
+        centroid[i] = (a[i] + b[i] + c[i]) * (1.0f / 3.0f);
+    }
+
+    std::vector<uint32_t> order(triCount);
+    for (uint32_t i = 0; i < triCount; ++i) order[i] = i;
+
+    // ---- 2) ビン分割 SAH でトップダウン構築 ----
+    m_nodes.reserve((size_t)triCount * 2);
+    m_nodes.push_back({ glm::vec3(0.0f), 0, glm::vec3(0.0f), triCount });
+
+    std::vector<uint32_t> stack;
+    stack.push_back(0);
+
+    while (!stack.empty())
+    {
+        const uint32_t nodeIdx = stack.back();
+        stack.pop_back();
+
+        const uint32_t first = m_nodes[nodeIdx].first;
+        const uint32_t count = m_nodes[nodeIdx].count;
+
+        Bounds nodeBounds, centBounds;
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            nodeBounds.grow(triBounds[order[i]]);
+            centBounds.grow(centroid[order[i]]);
+        }
+        m_nodes[nodeIdx].bmin = nodeBounds.bmin;
+        m_nodes[nodeIdx].bmax = nodeBounds.bmax;
+
+        if (count <= 2) continue;
+
+        // 各軸でビンに振り分け、左右の SAH コストが最小になる境界を探す
+        int bestAxis = -1;
+        int bestSplit = 0;
+        float bestCost = FLT_MAX;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float lo = centBounds.bmin[axis];
+            const float extent = centBounds.bmax[axis] - lo;
+            if (extent <= 0.0f) continue;
+
+            Bin bins[kBinCount];
+            const float scale = kBinCount / extent;
+            for (uint32_t i = first; i < first + count; ++i)
+            {
+                const uint32_t t = order[i];
+                const int bi = std::min(kBinCount - 1, (int)((centroid[t][axis] - lo) * scale));
+                bins[bi].count++;
+                bins[bi].bounds.grow(triBounds[t]);
+            }
+
+            float leftArea[kBinCount - 1], rightArea[kBinCount - 1];
+            uint32_t leftCount[kBinCount - 1], rightCount[kBinCount - 1];
+            Bounds lb, rb;
+            uint32_t lc = 0, rc = 0;
+            for (int i = 0; i < kBinCount - 1; ++i)
+            {
+                lc += bins[i].count;
+                lb.grow(bins[i].bounds);
+                leftCount[i] = lc;
+                leftArea[i] = lb.area();
+
+                rc += bins[kBinCount - 1 - i].count;
+                rb.grow(bins[kBinCount - 1 - i].bounds);
+                rightCount[kBinCount - 2 - i] = rc;
+                rightArea[kBinCount - 2 - i] = rb.area();
+            }
+
+            for (int i = 0; i < kBinCount - 1; ++i)
+            {
+                if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+                const float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        const float leafCost = count * nodeBounds.area();
+        if (bestAxis < 0 || (bestCost >= leafCost && count <= kMaxLeafSize))
+            continue;
+
+        // 分割境界で order を並べ替える
+        const float lo = centBounds.bmin[bestAxis];
+        const float scale = kBinCount / (centBounds.bmax[bestAxis] - lo);
+        auto mid = std::partition(order.begin() + first, order.begin() + first + count,
+            [&](uint32_t t)
+            {
+                const int bi = std::min(kBinCount - 1, (int)((centroid[t][bestAxis] - lo) * scale));
+                return bi <= bestSplit;
+            });
+
+        const uint32_t leftCount = (uint32_t)(mid - order.begin()) - first;
+        if (leftCount == 0 || leftCount == count) continue;
+
+        const uint32_t left = (uint32_t)m_nodes.size();
+        m_nodes.push_back({ glm::vec3(0.0f), first, glm::vec3(0.0f), leftCount });
+        m_nodes.push_back({ glm::vec3(0.0f), first + leftCount, glm::vec3(0.0f), count - leftCount });
+
+        m_nodes[nodeIdx].first = left;
+        m_nodes[nodeIdx].count = 0;
+
+        stack.push_back(left + 1);
+        stack.push_back(left);
+    }
+
+    // ---- 3) 三角形を葉の順に詰め直す ----
+    m_v0.resize(triCount);
+    m_e1.resize(triCount);
+    m_e2.resize(triCount);
+    m_faceId.resize(triCount);
+    for (uint32_t i = 0; i < triCount; ++i)
+    {
+        const uint32_t t = order[i];
+        m_v0[i] = a[t];
+        m_e1[i] = b[t] - a[t];
+        m_e2[i] = c[t] - a[t];
+        m_faceId[i] = faceId[t];
+    }
+}
+
+bool TriangleBvh::raycast(const Ray& ray, RayHit& hit) const
+{
+    if (m_nodes.empty()) return false;
+
+    const glm::vec3 invDir(1.0f / ray.dir.x, 1.0f / ray.dir.y, 1.0f / ray.dir.z);
+
+    float tBest = FLT_MAX;
+    uint32_t bestTri = EditMesh::kInvalid;
+
+    TraversalStack stack;
+
+    if (intersectAabb(m_nodes[0].bmin, m_nodes[0].bmax, ray.origin, invDir, tBest) == FLT_MAX)
+        return false;
+    stack.push(0);
+
+    while (!stack.empty())
+    {
+        const Node& node = m_nodes[stack.pop()];
+
+        if (node.count > 0)
+        {
+            // Möller–Trumbore（両面）
+            for (uint32_t i = node.first; i < node.first + node.count; ++i)
+            {
+                const glm::vec3 pv = glm::cross(ray.dir, m_e2[i]);
+                const float det = glm::dot(m_e1[i], pv);
+                if (std::fabs(det) < 1e-12f) continue;
+
+                const float invDet = 1.0f / det;
+                const glm::vec3 tv = ray.origin - m_v0[i];
+                const float u = glm::dot(tv, pv) * invDet;
+                if (u < 0.0f || u > 1.0f) continue;
+
+                const glm::vec3 qv = glm::cross(tv, m_e1[i]);
+                const float v = glm::dot(ray.dir, qv) * invDet;
+                if (v < 0.0f || u + v > 1.0f) continue;
+
+                const float t = glm::dot(m_e2[i], qv) * invDet;
+                if (t > 0.0f && t < tBest)
+                {
+                    tBest = t;
+                    bestTri = i;
+                }
+            }
+            continue;
+        }
+
+        // 近い子を後に積んで先に辿る
+        const Node& l = m_nodes[node.first];
+        const Node& r = m_nodes[node.first + 1];
+        float tl = intersectAabb(l.bmin, l.bmax, ray.origin, invDir, tBest);
+        float tr = intersectAabb(r.bmin, r.bmax, ray.origin, invDir, tBest);
+        uint32_t nl = node.first, nr = node.first + 1;
+        if (tl > tr)
+        {
+            std::swap(tl, tr);
+            std::swap(nl, nr);
+        }
+
+        if (tr != FLT_MAX) stack.push(nr);
+        if (tl != FLT_MAX) stack.push(nl);
+    }
+
+    if (bestTri == EditMesh::kInvalid) return false;
+
+    hit.faceId = m_faceId[bestTri];
+    hit.t = tBest;
+    return true;
+}
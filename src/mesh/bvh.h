@@ -0,0 +1,61 @@
+#pragma once
+
+#include "cstdint"
+#include "vector"
+
+#include "glm/glm.hpp"
+
+#include "mesh/edit_mesh.h"
+#include "mesh/ray.h"
+
+struct RayHit
+{
+    uint32_t faceId = 0;    ///< face + 1（0 はヒット無し）。ID バッファと同じ番号
+    float    t = 0.0f;      ///< レイパラメータ（ワールド距離）
+};
+
+/**
+ * @brief 三角形 BVH（CPU レイキャスト用）
+ *
+ * EditMesh の各面をファン分割した三角形に対して、
+ * ビン分割 SAH で二分木を構築する。
+ * ノードは 32 byte の配列に深さ優先で並べ、三角形は葉の順に詰め直す。
+ *
+ * GL に依存しないため、ウィンドウ無しでもピッキングできる。
+ */
+class TriangleBvh
+{
+public:
+    void build(const EditMesh& mesh);
+    void clear();
+
+    /**
+     * @brief 最も近い交差を求める
+     *
+     * @return ヒットしたら true（hit に面 ID と距離）
+     *
+     * 裏面も判定する（ID バッファ側もカリングしていないため）。
+     */
+    bool raycast(const Ray& ray, RayHit& hit) const;
+
+    uint32_t nodeCount() const { return (uint32_t)m_nodes.size(); }
+    uint32_t triangleCount() const { return (uint32_t)m_faceId.size(); }
+    bool empty() const { return m_nodes.empty(); }
+
+private:
+    struct Node
+    {
+        glm::vec3 bmin;
+        uint32_t  first;    ///< 内部ノード: 左子（右子は first + 1） / 葉: 先頭三角形
+        glm::vec3 bmax;
+        uint32_t  count;    ///< 葉の三角形数（0 なら内部ノード）
+    };
+
+    std::vector<Node> m_nodes;
+
+    // 三角形（SoA、Möller–Trumbore 用に辺ベクトルを前計算）
+    std::vector<glm::vec3> m_v0;
+    std::vector<glm::vec3> m_e1;
+    std::vector<glm::vec3> m_e2;
+    std::vector<uint32_t>  m_faceId;
+};
@@ -0,0 +1,216 @@
+#include "mesh/edit_mesh.h"
+
+#include "algorithm"
+#include "stdexcept"
+#include "utility"
+
+EditMesh::EditMesh() = default;
+
+EditMesh EditMesh::fromPolygons(
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> faceSizes,
+    std::span<const uint32_t> faceIndices)
+{
+    EditMesh mesh = buildFaces(positions, faceSizes, faceIndices);
+    mesh.buildTwins();
+    return mesh;
+}
+
+EditMesh EditMesh::fromPolygons(
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> faceSizes,
+    std::span<const uint32_t> faceIndices,
+    std::span<const uint32_t> twins,
+    uint32_t edgeCount)
+{
+    EditMesh mesh = buildFaces(positions, faceSizes, faceIndices);
+    mesh.setTwins(twins, edgeCount);
+    return mesh;
+}
+
+EditMesh EditMesh::buildFaces(
+    std::span<const glm::vec3> positions,
+    std::span<const uint32_t> faceSizes,
+    std::span<const uint32_t> faceIndices)
+{
+    EditMesh mesh;
+    mesh.reserve(positions.size(), faceSizes.size(), faceIndices.size());
+
+    for (const glm::vec3& p : positions)
+        mesh.addVertex(p);
+
+    size_t corner = 0;
+    for (uint32_t n : faceSizes)
+    {
+        if (corner + n > faceIndices.size())
+            throw std::runtime_error("EditMesh::fromPolygons face indices are truncated");
+        mesh.addFace(faceIndices.subspan(corner, n));
+        corner += n;
+    }
+    return mesh;
+}
+
+void EditMesh::clear()
+{
+    m_positions.clear();
+    m_vertHalfEdge.clear();
+
+    m_heNext.clear();
+    m_hePrev.clear();
+    m_heTwin.clear();
+    m_heVert.clear();
+    m_heFace.clear();
+
+    m_faceHalfEdge.clear();
+    m_faceDegree.clear();
+
+    m_edgeCount = 0;
+}
+
+void EditMesh::reserve(size_t vertexCount, size_t faceCount, size_t halfEdgeCount)
+{
+    m_positions.reserve(vertexCount);
+    m_vertHalfEdge.reserve(vertexCount);
+
+    m_heNext.reserve(halfEdgeCount);
+    m_hePrev.reserve(halfEdgeCount);
+    m_heTwin.reserve(halfEdgeCount);
+    m_heVert.reserve(halfEdgeCount);
+    m_heFace.reserve(halfEdgeCount);
+
+    m_faceHalfEdge.reserve(faceCount);
+    m_faceDegree.reserve(faceCount);
+}
+
+uint32_t EditMesh::addVertex(const glm::vec3& p)
+{
+    m_positions.push_back(p);
+    m_vertHalfEdge.push_back(kInvalid);
+    return (uint32_t)(m_positions.size() - 1);
+}
+
+uint32_t EditMesh::addFace(std::span<const uint32_t> verts)
+{
+    const uint32_t n = (uint32_t)verts.size();
+    if (n < 3) throw std::runtime_error("EditMesh::addFace requires at least 3 vertices");
+
+    const uint32_t f = (uint32_t)m_faceHalfEdge.size();
+    const uint32_t first = (uint32_t)m_heNext.size();
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        const uint32_t v = verts[i];
+        if (v >= m_positions.size()) throw std::runtime_error("EditMesh::addFace vertex index out of range");
+
+        const uint32_t he = first + i;
+        m_heNext.push_back(first + (i + 1) % n);
+        m_hePrev.push_back(first + (i + n - 1) % n);
+        m_heTwin.push_back(kInvalid);
+        m_heVert.push_back(v);
+        m_heFace.push_back(f);
+
+        if (m_vertHalfEdge[v] == kInvalid)
+            m_vertHalfEdge[v] = he;
+    }
+
+    m_faceHalfEdge.push_back(first);
+    m_faceDegree.push_back(n);
+    return f;
+}
+
+void EditMesh::buildTwins()
+{
+    const uint32_t heCount = halfEdgeCount();
+
+    // 無向辺キー (min << 32 | max) と半辺番号の組をソートし、同じキーの連続区間を辺とみなす
+    std::vector<std::pair<uint64_t, uint32_t>> keys;
+    keys.reserve(heCount);
+    for (uint32_t he = 0; he < heCount; ++he)
+    {
+        const uint64_t a = m_heVert[he];
+        const uint64_t b = destVertex(he);
+        keys.emplace_back(a < b ? (a << 32 | b) : (b << 32 | a), he);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::fill(m_heTwin.begin(), m_heTwin.end(), kInvalid);
+    m_edgeCount = 0;
+
+    for (size_t i = 0; i < keys.size();)
+    {
+        size_t j = i + 1;
+        while (j < keys.size() && keys[j].first == keys[i].first) ++j;
+
+        ++m_edgeCount;
+        if (j - i == 2)
+        {
+            const uint32_t h0 = keys[i].second;
+            const uint32_t h1 = keys[i + 1].second;
+
+            // 逆向きのときだけ twin（同じ向きは面の向きが不整合）
+            if (m_heVert[h0] == destVertex(h1))
+            {
+                m_heTwin[h0] = h1;
+                m_heTwin[h1] = h0;
+            }
+        }
+        i = j;
+    }
+
+    updateBoundaryHalfEdges();
+}
+
+void EditMesh::setTwins(std::span<const uint32_t> twins, uint32_t edgeCount)
+{
+    const uint32_t heCount = halfEdgeCount();
+    if (twins.size() != heCount || edgeCount > heCount)
+        throw std::runtime_error("EditMesh::setTwins count mismatch");
+
+    // 外から来た配列なので、buildTwins() が作りうる形かだけ O(H) で確かめる
+    for (uint32_t he = 0; he < heCount; ++he)
+    {
+        const uint32_t t = twins[he];
+        if (t == kInvalid) continue;
+        if (t >= heCount || t == he || twins[t] != he ||
+            m_heVert[he] != destVertex(t) || m_heVert[t] != destVertex(he))
+            throw std::runtime_error("EditMesh::setTwins invalid twin");
+    }
+
+    m_heTwin.assign(twins.begin(), twins.end());
+    m_edgeCount = edgeCount;
+    updateBoundaryHalfEdges();
+}
+
+void EditMesh::updateBoundaryHalfEdges()
+{
+    // 境界頂点は境界半辺から回せるようにしておく
+    for (uint32_t he = 0; he < halfEdgeCount(); ++he)
+    {
+        if (m_heTwin[he] == kInvalid)
+            m_vertHalfEdge[m_heVert[he]] = he;
+    }
+}
+
+glm::vec3 EditMesh::faceNormal(uint32_t f) const
+{
+    // Newell 法（非平面の多角形でも安定）
+    glm::vec3 n(0.0f);
+    forEachFaceHalfEdge(f, [&](uint32_t he)
+        {
+            const glm::vec3& a = m_positions[m_heVert[he]];
+            const glm::vec3& b = m_positions[destVertex(he)];
+            n.x += (a.y - b.y) * (a.z + b.z);
+            n.y += (a.z - b.z) * (a.x + b.x);
+            n.z += (a.x - b.x) * (a.y + b.y);
+        });
+
+    const float len = glm::length(n);
+    return (len > 0.0f) ? n / len : glm::vec3(0.0f);
+}
+
+glm::vec3 EditMesh::faceCenter(uint32_t f) const
+{
+    glm::vec3 c(0.0f);
+    forEachFaceVertex(f, [&](uint32_t v) { c += m_positions[v]; });
+    return c / (float)m_faceDegree[f];
+}
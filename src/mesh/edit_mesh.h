@@ -0,0 +1,203 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+#include "vector"
+
+#include "glm/glm.hpp"
+
+/**
+ * @brief 半辺（half-edge）構造による編集用メッシュ
+ *
+ * 頂点位置・半辺の next / prev / twin / vertex / face を
+ * それぞれ独立したフラット配列（SoA）として保持する。
+ * インデックスはすべて uint32_t で、無効値は kInvalid。
+ *
+ * - 面 f の半辺は addFace() の順に連続して確保される
+ * - vertex(he) は半辺の始点（origin）
+ * - twin が kInvalid の半辺は境界（または非多様体）
+ *
+ * 面・辺・頂点の隣接クエリはすべて配列参照のみで O(1)。
+ * GL には依存しないため、ウィンドウ無しでも利用できる。
+ */
+class EditMesh
+{
+public:
+    static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+
+    EditMesh();
+
+    /**
+     * @brief 多角形リストから構築する（twin まで解決済み）
+     *
+     * @param faceSizes   各面の頂点数
+     * @param faceIndices 面ごとの頂点インデックスを連結したもの
+     */
+    static EditMesh fromPolygons(
+        std::span<const glm::vec3> positions,
+        std::span<const uint32_t> faceSizes,
+        std::span<const uint32_t> faceIndices);
+
+    /**
+     * @brief 解決済みの twin（キャッシュに保存したもの）を使って構築する
+     *
+     * buildTwins() のソートを省く。twins と edgeCount は setTwins() を参照。
+     */
+    static EditMesh fromPolygons(
+        std::span<const glm::vec3> positions,
+        std::span<const uint32_t> faceSizes,
+        std::span<const uint32_t> faceIndices,
+        std::span<const uint32_t> twins,
+        uint32_t edgeCount);
+
+    // ===== Build =====
+
+    void clear();
+    void reserve(size_t vertexCount, size_t faceCount, size_t halfEdgeCount);
+
+    /**
+     * @brief 頂点を追加する
+     *
+     * @return 追加した頂点のインデックス
+     */
+    uint32_t addVertex(const glm::vec3& p);
+
+    /**
+     * @brief 多角形面を追加する
+     *
+     * @param verts 頂点インデックス（反時計回り、3 以上）
+     * @return 追加した面のインデックス
+     *
+     * twin は buildTwins() を呼ぶまで解決されない。
+     */
+    uint32_t addFace(std::span<const uint32_t> verts);
+
+    /**
+     * @brief 全半辺の twin を解決する
+     *
+     * (min, max) 頂点ペアでソートして対を探す。
+     * ちょうど 2 本の逆向き半辺が共有する辺のみ twin を張り、
+     * それ以外（境界・非多様体）は kInvalid のまま残す。
+     * 境界頂点の vertexHalfEdge は境界側の半辺を指すように更新する。
+     */
+    void buildTwins();
+
+    /**
+     * @brief buildTwins() の結果（halfEdgeTwin() と edgeCount()）をそのまま設定する
+     *
+     * 対になっていない・同じ辺の逆向きでない twin があれば std::runtime_error。
+     * 非多様体の辺は twin から数えられないので、辺の数も受け取る。
+     */
+    void setTwins(std::span<const uint32_t> twins, uint32_t edgeCount);
+
+    // ===== Counts =====
+
+    uint32_t vertexCount() const { return (uint32_t)m_positions.size(); }
+    uint32_t faceCount() const { return (uint32_t)m_faceHalfEdge.size(); }
+    uint32_t halfEdgeCount() const { return (uint32_t)m_heNext.size(); }
+    uint32_t edgeCount() const { return m_edgeCount; }
+
+    // ===== Adjacency (O(1)) =====
+
+    const glm::vec3& position(uint32_t v) const { return m_positions[v]; }
+    void setPosition(uint32_t v, const glm::vec3& p) { m_positions[v] = p; }
+
+    uint32_t vertexHalfEdge(uint32_t v) const { return m_vertHalfEdge[v]; }
+    uint32_t faceHalfEdge(uint32_t f) const { return m_faceHalfEdge[f]; }
+    uint32_t faceDegree(uint32_t f) const { return m_faceDegree[f]; }
+
+    uint32_t next(uint32_t he) const { return m_heNext[he]; }
+    uint32_t prev(uint32_t he) const { return m_hePrev[he]; }
+    uint32_t twin(uint32_t he) const { return m_heTwin[he]; }
+    uint32_t vertex(uint32_t he) const { return m_heVert[he]; }
+    uint32_t face(uint32_t he) const { return m_heFace[he]; }
+    uint32_t destVertex(uint32_t he) const { return m_heVert[m_heNext[he]]; }
+    bool isBoundary(uint32_t he) const { return m_heTwin[he] == kInvalid; }
+
+    /**
+     * @brief 辺の代表半辺かどうか
+     *
+     * twin を持たないか、twin より小さいインデックスなら代表。
+     * 全半辺をこれで絞り込むと各辺をちょうど 1 回ずつ列挙できる。
+     */
+    bool isEdgeRepresentative(uint32_t he) const
+    {
+        const uint32_t t = m_heTwin[he];
+        return t == kInvalid || he < t;
+    }
+
+    glm::vec3 faceNormal(uint32_t f) const;
+    glm::vec3 faceCenter(uint32_t f) const;
+
+    // ===== Traversal =====
+
+    template <class Fn>
+    void forEachFaceHalfEdge(uint32_t f, Fn&& fn) const
+    {
+        const uint32_t first = m_faceHalfEdge[f];
+        uint32_t he = first;
+        do
+        {
+            fn(he);
+            he = m_heNext[he];
+        } while (he != first);
+    }
+
+    template <class Fn>
+    void forEachFaceVertex(uint32_t f, Fn&& fn) const
+    {
+        forEachFaceHalfEdge(f, [&](uint32_t he) { fn(m_heVert[he]); });
+    }
+
+    /**
+     * @brief 頂点 v から出る半辺を一周列挙する
+     *
+     * twin(prev(he)) で回転する。境界頂点では
+     * vertexHalfEdge が境界半辺を指しているため、扇全体を漏れなく辿れる。
+     */
+    template <class Fn>
+    void forEachVertexOutgoing(uint32_t v, Fn&& fn) const
+    {
+        const uint32_t first = m_vertHalfEdge[v];
+        if (first == kInvalid) return;
+
+        uint32_t he = first;
+        do
+        {
+            fn(he);
+            he = m_heTwin[m_hePrev[he]];
+        } while (he != kInvalid && he != first);
+    }
+
+    // ===== Raw SoA arrays =====
+
+    const std::vector<glm::vec3>& positions() const { return m_positions; }
+    const std::vector<uint32_t>& halfEdgeNext() const { return m_heNext; }
+    const std::vector<uint32_t>& halfEdgeTwin() const { return m_heTwin; }
+    const std::vector<uint32_t>& halfEdgeVertex() const { return m_heVert; }
+    const std::vector<uint32_t>& halfEdgeFace() const { return m_heFace; }
+
+private:
+    static EditMesh buildFaces(
+        std::span<const glm::vec3> positions,
+        std::span<const uint32_t> faceSizes,
+        std::span<const uint32_t> faceIndices);
+    void updateBoundaryHalfEdges();
+
+    // --- Vertex ---
+    std::vector<glm::vec3> m_positions;
+    std::vector<uint32_t>  m_vertHalfEdge;   ///< 頂点から出る半辺（1本）
+
+    // --- Half-edge ---
+    std::vector<uint32_t> m_heNext;
+    std::vector<uint32_t> m_hePrev;
+    std::vector<uint32_t> m_heTwin;
+    std::vector<uint32_t> m_heVert;          ///< 始点
+    std::vector<uint32_t> m_heFace;
+
+    // --- Face ---
+    std::vector<uint32_t> m_faceHalfEdge;    ///< 面の先頭半辺
+    std::vector<uint32_t> m_faceDegree;      ///< 面の頂点数
+
+    uint32_t m_edgeCount = 0;
+};
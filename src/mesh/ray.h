@@ -0,0 +1,39 @@
+#pragma once
+
+#include "cmath"
+
+#include "glm/glm.hpp"
+
+struct Ray
+{
+    glm::vec3 origin{ 0.0f };
+    glm::vec3 dir{ 0.0f, 0.0f, -1.0f };   ///< 正規化済み
+
+    /**
+     * @brief スクリーン座標からワールド空間のレイを作る
+     *
+     * @param invVP (proj * view) の逆行列
+     * @param mouseX, mouseY ウィンドウ座標（左上原点、ピクセル）
+     *
+     * ID バッファ方式と同じ結果になるよう、ピクセル中心を通すレイにする。
+     * near 面 (z = -1) と far 面 (z = +1) を逆射影して結ぶ。
+     */
+    static Ray fromScreen(const glm::mat4& invVP, double mouseX, double mouseY, int fbW, int fbH)
+    {
+        const float px = (float)std::floor(mouseX) + 0.5f;
+        const float py = (float)std::floor(mouseY) + 0.5f;
+
+        const float ndcX = 2.0f * px / (float)fbW - 1.0f;
+        const float ndcY = 1.0f - 2.0f * py / (float)fbH;
+
+        glm::vec4 n = invVP * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+        glm::vec4 f = invVP * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+        const glm::vec3 pn = glm::vec3(n) / n.w;
+        const glm::vec3 pf = glm::vec3(f) / f.w;
+
+        Ray r;
+        r.origin = pn;
+        r.dir = glm::normalize(pf - pn);
+        return r;
+    }
+};
@@ -2,12 +2,17 @@
 #include "platform/input.h"
 
 Platform::Platform()
+    : Platform(PlatformOptions{})
 {
-    setWindowHints();
-    m_window = createWindow(1280, 720, "MyModeler");
+}
+
+Platform::Platform(const PlatformOptions& options)
+{
+    setWindowHints(options.visible);
+    m_window = createWindow(options.width, options.height, options.title);
 
     glfwMakeContextCurrent(m_window.get());
-    glfwSwapInterval(1);
+    glfwSwapInterval(options.vsync ? 1 : 0);
 
     Input::InstallInputCallbacks(m_window.get(), &m_input);
 }
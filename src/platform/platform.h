@@ -4,10 +4,20 @@
 #include "platform/input.h"
 #include "platform/window.h"
 
+struct PlatformOptions
+{
+    int         width = 1280;
+    int         height = 720;
+    const char* title = "MyModeler";
+    bool        visible = true;     ///< false なら非表示ウィンドウ（ベンチマーク用。コンテキストは普通に使える）
+    bool        vsync = true;
+};
+
 class Platform
 {
 public:
     Platform();
+    explicit Platform(const PlatformOptions& options);
     ~Platform();
 
     void beginFrame();
@@ -29,12 +39,13 @@ private:
     UniqueGlfwWindow m_window;
     InputState m_input;
 
-    static void setWindowHints()
+    static void setWindowHints(bool visible)
     {
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
         glfwWindowHint(GLFW_SRGB_CAPABLE, GLFW_TRUE);
+        glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
     }
 
     static UniqueGlfwWindow createWindow(int w, int h, const char* title)
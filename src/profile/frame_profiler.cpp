@@ -0,0 +1,180 @@
+#include "frame_profiler.h"
+
+#include "stdexcept"
+#include "utility"
+
+FrameProfiler::FrameProfiler() = default;
+
+FrameProfiler::~FrameProfiler()
+{
+    destroy();
+}
+
+void FrameProfiler::init()
+{
+    destroy();
+
+    for (FrameSlot& slot : m_slots)
+        glGenQueries((GLsizei)kMaxSections, slot.queries.data());
+    m_initialized = true;
+}
+
+void FrameProfiler::destroy()
+{
+    stopCsv();
+
+    if (m_initialized)
+    {
+        if (m_activeGpu >= 0) glEndQuery(GL_TIME_ELAPSED);
+        for (FrameSlot& slot : m_slots)
+            glDeleteQueries((GLsizei)kMaxSections, slot.queries.data());
+    }
+    for (FrameSlot& slot : m_slots)
+        slot = FrameSlot{};
+    m_activeGpu = -1;
+    m_initialized = false;
+}
+
+FrameProfiler::Section FrameProfiler::addCpuSection(std::string name)
+{
+    return addSection(std::move(name), false);
+}
+
+FrameProfiler::Section FrameProfiler::addGpuSection(std::string name)
+{
+    return addSection(std::move(name), true);
+}
+
+FrameProfiler::Section FrameProfiler::addSection(std::string name, bool gpu)
+{
+    if (m_sections.size() >= kMaxSections)
+        throw std::runtime_error("FrameProfiler supports at most 16 sections");
+    if (m_csv)
+        throw std::runtime_error("FrameProfiler sections cannot be added while writing CSV");
+
+    SectionInfo info;
+    info.name = std::move(name);
+    info.gpu = gpu;
+    m_sections.push_back(std::move(info));
+    return (Section)(m_sections.size() - 1);
+}
+
+void FrameProfiler::beginFrame()
+{
+    // 同じ枠を使った 2 フレーム前の結果を読んでから空ける
+    FrameSlot& slot = current();
+    if (slot.pending) resolve(slot);
+
+    slot.frame = m_frame;
+    slot.pending = false;
+    slot.frameMillis = 0.0;
+    slot.cpuMillis.fill(0.0);
+    slot.issued.fill(false);
+
+    m_frameStart = Clock::now();
+}
+
+void FrameProfiler::endFrame()
+{
+    FrameSlot& slot = current();
+    if (m_activeGpu >= 0) endGpu((Section)m_activeGpu);
+
+    slot.frameMillis = std::chrono::duration<double, std::milli>(Clock::now() - m_frameStart).count();
+    slot.pending = true;
+    ++m_frame;
+}
+
+void FrameProfiler::beginCpu(Section s)
+{
+    m_cpuStart[s] = Clock::now();
+}
+
+void FrameProfiler::endCpu(Section s)
+{
+    current().cpuMillis[s] += std::chrono::duration<double, std::milli>(Clock::now() - m_cpuStart[s]).count();
+}
+
+void FrameProfiler::beginGpu(Section s)
+{
+    FrameSlot& slot = current();
+    if (!m_initialized || m_activeGpu >= 0 || slot.issued[s]) return;
+
+    glBeginQuery(GL_TIME_ELAPSED, slot.queries[s]);
+    slot.issued[s] = true;
+    m_activeGpu = (int)s;
+}
+
+void FrameProfiler::endGpu(Section s)
+{
+    if (m_activeGpu != (int)s) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_activeGpu = -1;
+}
+
+bool FrameProfiler::startCsv(const std::string& path)
+{
+    stopCsv();
+
+    m_csv = std::fopen(path.c_str(), "w");
+    if (!m_csv) return false;
+    m_csvPath = path;
+
+    std::fputs("frame,frame_cpu_ms", m_csv);
+    for (const SectionInfo& info : m_sections)
+        std::fprintf(m_csv, ",%s_%s_ms", info.name.c_str(), info.gpu ? "gpu" : "cpu");
+    std::fputc('\n', m_csv);
+    return true;
+}
+
+void FrameProfiler::stopCsv()
+{
+    if (m_csv) std::fclose(m_csv);
+    m_csv = nullptr;
+}
+
+void FrameProfiler::resolve(FrameSlot& slot)
+{
+    m_frameStats.push(slot.frameMillis);
+    if (m_csv) std::fprintf(m_csv, "%llu,%.4f", (unsigned long long)slot.frame, slot.frameMillis);
+
+    for (Section s = 0; s < (Section)m_sections.size(); ++s)
+    {
+        SectionInfo& info = m_sections[s];
+        if (!info.gpu)
+        {
+            info.stats.push(slot.cpuMillis[s]);
+            if (m_csv) std::fprintf(m_csv, ",%.4f", slot.cpuMillis[s]);
+            continue;
+        }
+
+        // そのフレームで通らなかった区間は空欄（0 として集計すると min / avg が歪む）
+        bool have = false;
+        double millis = 0.0;
+        if (slot.issued[s])
+        {
+            GLint available = 0;
+            glGetQueryObjectiv(slot.queries[s], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available)
+            {
+                GLuint64 ns = 0;
+                glGetQueryObjectui64v(slot.queries[s], GL_QUERY_RESULT, &ns);
+                millis = (double)ns * 1e-6;
+                have = true;
+            }
+            else
+            {
+                ++m_dropped;
+            }
+        }
+
+        if (have) info.stats.push(millis);
+        if (m_csv)
+        {
+            if (have) std::fprintf(m_csv, ",%.4f", millis);
+            else std::fputc(',', m_csv);
+        }
+    }
+
+    if (m_csv) std::fputc('\n', m_csv);
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "array"
+#include "chrono"
+#include "cstdint"
+#include "cstdio"
+#include "string"
+#include "vector"
+
+#include "glad/glad.h"
+
+#include "profile/rolling_stats.h"
+
+/**
+ * @brief フレーム内の区間ごとの CPU / GPU 時間
+ *
+ * 区間は起動時に addCpuSection() / addGpuSection() で登録し、
+ * フレーム中は CpuScope / GpuScope で囲む。
+ *
+ * - CPU は steady_clock。同じ区間を 1 フレームに何度通っても合計する
+ * - GPU は GL_TIME_ELAPSED のクエリ。入れ子にできないので、GPU 区間どうしは重ねないこと。
+ *   1 フレームに 1 回だけ（2 回目以降は無視）
+ * - クエリは kFramesInFlight フレーム分を交互に使い、結果は同じ枠を再利用する直前
+ *   （= 2 フレーム後）に読む。まだ終わっていなければ待たずにそのフレームの値を捨てる
+ *
+ * 集計（直近 kWindow フレームの min / avg / p99）と CSV の 1 行は、
+ * GPU の結果がそろうこの時点でまとめて行う（表示は 2 フレーム遅れる）。
+ */
+class FrameProfiler
+{
+public:
+    using Section = uint32_t;
+
+    static constexpr uint32_t kMaxSections = 16;
+    static constexpr int kFramesInFlight = 2;
+    static constexpr size_t kWindow = 240;
+
+    FrameProfiler();
+    ~FrameProfiler();
+
+    /// GPU 区間を使う場合は GL コンテキストを作ってから呼ぶ
+    void init();
+    void destroy();
+
+    Section addCpuSection(std::string name);
+    Section addGpuSection(std::string name);
+
+    void beginFrame();
+    void endFrame();
+
+    void beginCpu(Section s);
+    void endCpu(Section s);
+    void beginGpu(Section s);
+    void endGpu(Section s);
+
+    class CpuScope
+    {
+    public:
+        CpuScope(FrameProfiler& p, Section s) : m_p(p), m_s(s) { m_p.beginCpu(m_s); }
+        ~CpuScope() { m_p.endCpu(m_s); }
+        CpuScope(const CpuScope&) = delete;
+        CpuScope& operator=(const CpuScope&) = delete;
+    private:
+        FrameProfiler& m_p;
+        Section m_s;
+    };
+
+    class GpuScope
+    {
+    public:
+        GpuScope(FrameProfiler& p, Section s) : m_p(p), m_s(s) { m_p.beginGpu(m_s); }
+        ~GpuScope() { m_p.endGpu(m_s); }
+        GpuScope(const GpuScope&) = delete;
+        GpuScope& operator=(const GpuScope&) = delete;
+    private:
+        FrameProfiler& m_p;
+        Section m_s;
+    };
+
+    uint32_t sectionCount() const { return (uint32_t)m_sections.size(); }
+    const std::string& name(Section s) const { return m_sections[s].name; }
+    bool isGpu(Section s) const { return m_sections[s].gpu; }
+    const RollingStats& stats(Section s) const { return m_sections[s].stats; }   ///< ミリ秒
+    const RollingStats& frameStats() const { return m_frameStats; }              ///< beginFrame〜endFrame（ミリ秒）
+    uint32_t droppedGpuSamples() const { return m_dropped; }
+
+    /**
+     * @brief 1 フレーム 1 行の CSV を書き始める
+     *
+     * 列は frame, frame_cpu_ms, 各区間（<name>_cpu_ms / <name>_gpu_ms）。取れなかった GPU 値は空欄。
+     * @return 開けなければ false
+     */
+    bool startCsv(const std::string& path);
+    void stopCsv();
+    bool csvActive() const { return m_csv != nullptr; }
+    const std::string& csvPath() const { return m_csvPath; }
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct SectionInfo
+    {
+        std::string  name;
+        bool         gpu = false;
+        RollingStats stats{ kWindow };
+    };
+
+    // 1 フレーム分の記録（GPU の結果が読めるまで保持する）
+    struct FrameSlot
+    {
+        uint64_t frame = 0;
+        bool     pending = false;
+        double   frameMillis = 0.0;
+        std::array<double, kMaxSections> cpuMillis{};
+        std::array<GLuint, kMaxSections> queries{};
+        std::array<bool, kMaxSections>   issued{};
+    };
+
+    std::vector<SectionInfo> m_sections;
+    std::array<FrameSlot, kFramesInFlight> m_slots;
+    std::array<Clock::time_point, kMaxSections> m_cpuStart{};
+    RollingStats m_frameStats{ kWindow };
+    Clock::time_point m_frameStart{};
+    uint64_t m_frame = 0;
+    int      m_activeGpu = -1;      ///< 計測中の GPU 区間（無ければ -1）
+    uint32_t m_dropped = 0;
+    bool     m_initialized = false;
+
+    std::FILE*  m_csv = nullptr;
+    std::string m_csvPath;
+
+    Section addSection(std::string name, bool gpu);
+    FrameSlot& current() { return m_slots[m_frame % kFramesInFlight]; }
+    void resolve(FrameSlot& slot);
+};
@@ -0,0 +1,56 @@
+#include "rolling_stats.h"
+
+#include "algorithm"
+#include "cmath"
+
+RollingStats::RollingStats(size_t window)
+    : m_samples(std::max<size_t>(window, 1), 0.0)
+{
+}
+
+void RollingStats::push(double value)
+{
+    m_samples[m_next] = value;
+    m_next = (m_next + 1) % m_samples.size();
+    m_count = std::min(m_count + 1, m_samples.size());
+}
+
+void RollingStats::clear()
+{
+    m_next = 0;
+    m_count = 0;
+}
+
+double RollingStats::min() const
+{
+    if (m_count == 0) return 0.0;
+    return *std::min_element(m_samples.begin(), m_samples.begin() + m_count);
+}
+
+double RollingStats::max() const
+{
+    if (m_count == 0) return 0.0;
+    return *std::max_element(m_samples.begin(), m_samples.begin() + m_count);
+}
+
+double RollingStats::average() const
+{
+    if (m_count == 0) return 0.0;
+
+    double sum = 0.0;
+    for (size_t i = 0; i < m_count; ++i)
+        sum += m_samples[i];
+    return sum / (double)m_count;
+}
+
+double RollingStats::percentile(double p) const
+{
+    if (m_count == 0) return 0.0;
+
+    // 最近傍順位法（p99 は上位 1% の境界のサンプルそのもの）
+    m_sorted.assign(m_samples.begin(), m_samples.begin() + m_count);
+    const double rank = std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * (double)m_count);
+    const size_t k = (size_t)std::max(rank, 1.0) - 1;
+    std::nth_element(m_sorted.begin(), m_sorted.begin() + k, m_sorted.end());
+    return m_sorted[k];
+}
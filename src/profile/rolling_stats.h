@@ -0,0 +1,34 @@
+#pragma once
+
+#include "cstddef"
+#include "vector"
+
+/**
+ * @brief 直近 N 個のサンプルの min / avg / パーセンタイル
+ *
+ * リングバッファに保持し、push() は O(1)。
+ * percentile() は呼ぶたびに窓をコピーして nth_element する（UI から 1 フレーム数回程度を想定）。
+ * GL には依存しない。
+ */
+class RollingStats
+{
+public:
+    explicit RollingStats(size_t window = 240);
+
+    void push(double value);
+    void clear();
+
+    size_t count() const { return m_count; }
+    double min() const;
+    double max() const;
+    double average() const;
+
+    /// p は [0, 100]。サンプルが無ければ 0
+    double percentile(double p) const;
+
+private:
+    std::vector<double> m_samples;
+    size_t m_next = 0;
+    size_t m_count = 0;
+    mutable std::vector<double> m_sorted;   ///< percentile() の作業用
+};
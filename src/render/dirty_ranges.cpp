@@ -0,0 +1,43 @@
+#include "render/dirty_ranges.h"
+
+#include "algorithm"
+
+void DirtyRanges::add(uint32_t first, uint32_t count)
+{
+    if (count == 0 || m_all) return;
+
+    uint32_t begin = first;
+    uint32_t end = first + count;
+
+    // begin - gap 以降で終わる最初の範囲から、end + gap までに始まる範囲をすべて飲み込む
+    auto lo = std::lower_bound(m_ranges.begin(), m_ranges.end(), begin,
+        [&](const Range& r, uint32_t b) { return r.end() + m_mergeGap < b; });
+
+    auto hi = lo;
+    while (hi != m_ranges.end() && hi->first <= end + m_mergeGap)
+    {
+        begin = std::min(begin, hi->first);
+        end = std::max(end, hi->end());
+        m_dirtyCount -= hi->count;
+        ++hi;
+    }
+
+    if (lo == hi)
+    {
+        m_ranges.insert(lo, Range{ begin, end - begin });
+    }
+    else
+    {
+        *lo = Range{ begin, end - begin };
+        m_ranges.erase(lo + 1, hi);
+    }
+    m_dirtyCount += end - begin;
+
+    // 散らばった追加が続くと挿入のたびに O(R) かかる。どうせ全体を送るので畳む
+    if (m_ranges.size() > m_maxRanges)
+    {
+        m_ranges.clear();
+        m_dirtyCount = UINT32_MAX;
+        m_all = true;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+#include "vector"
+
+/**
+ * @brief GPU バッファの書き換えが必要な要素範囲の集合
+ *
+ * 範囲は offset 昇順・互いに素で保持し、追加時に隣接・重なりを結合する。
+ * 間隔が mergeGap 要素以下の範囲も 1 つにまとめる
+ * （数要素ぶん余計に送る方が glBufferSubData を 2 回呼ぶより安い）。
+ * 範囲数が maxRanges を超えたら「全体が汚れている」状態に畳む。
+ * どうせ全体を送るので、以降の add は範囲を探さずに O(1) で返る。
+ * GL には依存しない。
+ */
+class DirtyRanges
+{
+public:
+    struct Range
+    {
+        uint32_t first, count;
+        uint32_t end() const { return first + count; }
+    };
+
+    explicit DirtyRanges(uint32_t mergeGap = 16, size_t maxRanges = 64)
+        : m_mergeGap(mergeGap), m_maxRanges(maxRanges) {}
+
+    void add(uint32_t first, uint32_t count);
+    void clear() { m_ranges.clear(); m_dirtyCount = 0; m_all = false; }
+
+    bool empty() const { return !m_all && m_ranges.empty(); }
+    /// 全体が汚れている（範囲数が maxRanges を超えた）。このとき ranges() は空
+    bool all() const { return m_all; }
+    std::span<const Range> ranges() const { return m_ranges; }
+    /// all() の間は UINT32_MAX
+    uint32_t dirtyCount() const { return m_dirtyCount; }
+
+    /**
+     * @brief 範囲ごとに送るより全体を 1 回で送るべきか
+     *
+     * 全体が汚れているか、汚れた要素が全体の fullRatio を超えたら true。
+     */
+    bool preferFullUpload(uint32_t totalCount, float fullRatio = 0.5f) const
+    {
+        return m_all || m_dirtyCount > (uint32_t)((float)totalCount * fullRatio);
+    }
+
+    /**
+     * @brief 汚れた範囲を write(first, span) で送り出して空にする
+     *
+     * preferFullUpload() なら全体を 1 回で送る。
+     * @return 送ったバイト数
+     */
+    template <class T, class Fn>
+    size_t flush(std::span<const T> data, Fn&& write)
+    {
+        if (empty()) return 0;
+
+        size_t bytes = 0;
+        if (preferFullUpload((uint32_t)data.size()))
+        {
+            write(0u, data);
+            bytes = data.size_bytes();
+        }
+        else
+        {
+            for (const Range& r : m_ranges)
+            {
+                const std::span<const T> part = data.subspan(r.first, r.count);
+                write(r.first, part);
+                bytes += part.size_bytes();
+            }
+        }
+        clear();
+        return bytes;
+    }
+
+private:
+    std::vector<Range> m_ranges;
+    uint32_t m_dirtyCount = 0;      ///< 範囲の要素数の合計（結合で埋めた隙間も含む）
+    uint32_t m_mergeGap;
+    size_t m_maxRanges;
+    bool m_all = false;
+};
@@ -0,0 +1,75 @@
+#include "face_mesh.h"
+
+#include "algorithm"
+
+#include "render/gl_state.h"
+#include "render/vertex_layout.h"
+
+FaceMesh::~FaceMesh()
+{
+    destroy();
+}
+
+void FaceMesh::upload(const FaceTriangles& tris)
+{
+    destroy();
+
+    m_faceFirst = tris.faceFirst;
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+    glGenBuffers(1, &m_idVbo);
+
+    gl_state::bindVertexArray(m_vao);
+    gl_state::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, tris.positions.size() * sizeof(glm::vec3), tris.positions.data(), GL_STATIC_DRAW);
+
+    vertex_layout::apply(vertex_layout::of<glm::vec3>());
+
+    // 面 ID = face + 1（0 はクリア値 = 何も無い）
+    std::vector<uint32_t> ids(tris.positions.size());
+    for (uint32_t f = 0; f < faceCount(); ++f)
+        std::fill(ids.begin() + m_faceFirst[f], ids.begin() + m_faceFirst[f + 1], f + 1);
+
+    gl_state::bindBuffer(GL_ARRAY_BUFFER, m_idVbo);
+    glBufferData(GL_ARRAY_BUFFER, ids.size() * sizeof(uint32_t), ids.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(vertex_location::kFaceId);
+    glVertexAttribIPointer(vertex_location::kFaceId, 1, GL_UNSIGNED_INT, 0, nullptr);
+}
+
+size_t FaceMesh::update(std::span<const glm::vec3> positions, DirtyRanges& dirty)
+{
+    if (!m_vbo) { dirty.clear(); return 0; }
+
+    gl_state::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    const size_t bytes = dirty.flush(positions, [](uint32_t first, std::span<const glm::vec3> part)
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)first * sizeof(glm::vec3), part.size_bytes(), part.data());
+        });
+    return bytes;
+}
+
+void FaceMesh::draw() const
+{
+    if (!m_vao) return;
+
+    gl_state::bindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, vertexCount());
+}
+
+void FaceMesh::drawFace(uint32_t face) const
+{
+    if (face >= faceCount()) return;
+
+    gl_state::bindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, faceFirst(face), faceVertexCount(face));
+}
+
+void FaceMesh::destroy()
+{
+    if (m_vbo) gl_state::deleteBuffer(m_vbo);
+    if (m_idVbo) gl_state::deleteBuffer(m_idVbo);
+    if (m_vao) gl_state::deleteVertexArray(m_vao);
+    m_vao = 0; m_vbo = 0; m_idVbo = 0;
+    m_faceFirst.clear();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "vector"
+
+#include "glad/glad.h"
+
+#include "render/dirty_ranges.h"
+#include "render/mesh_builder.h"
+
+// 面単位で描画範囲を引ける位置のみのメッシュ（ピッキング / 選択ハイライト用）
+// 頂点ごとの面 ID（face + 1）を別バッファに持つので、ID パスは全面を 1 回で描ける
+class FaceMesh
+{
+public:
+    GLuint m_vao = 0, m_vbo = 0;
+    GLuint m_idVbo = 0;     ///< 面 ID。位置の部分更新では触らない
+    std::vector<uint32_t> m_faceFirst;
+
+    ~FaceMesh();
+
+    void upload(const FaceTriangles& tris);
+
+    /// positions（upload 時と同じ並び）のうち dirty の範囲だけを送る。@return 送ったバイト数
+    size_t update(std::span<const glm::vec3> positions, DirtyRanges& dirty);
+    void draw() const;
+    void drawFace(uint32_t face) const;
+    void destroy();
+
+    uint32_t faceCount() const { return m_faceFirst.empty() ? 0 : (uint32_t)m_faceFirst.size() - 1; }
+    GLsizei vertexCount() const { return m_faceFirst.empty() ? 0 : (GLsizei)m_faceFirst.back(); }
+    GLint faceFirst(uint32_t face) const { return (GLint)m_faceFirst[face]; }
+    GLsizei faceVertexCount(uint32_t face) const { return (GLsizei)(m_faceFirst[face + 1] - m_faceFirst[face]); }
+};
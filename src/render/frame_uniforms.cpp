@@ -0,0 +1,58 @@
+#include "frame_uniforms.h"
+
+#include "render/gl_state.h"
+
+FrameUniforms FrameUniforms::make(const glm::mat4& view, const glm::mat4& proj, int w, int h,
+    float seconds, float deltaSeconds, uint32_t frameIndex)
+{
+    FrameUniforms f;
+    f.view = view;
+    f.proj = proj;
+    f.viewProj = proj * view;
+    f.invViewProj = glm::inverse(f.viewProj);
+    f.viewport = glm::vec4(0.0f, 0.0f, (float)w, (float)h);
+    f.time = glm::vec4(seconds, deltaSeconds, (float)frameIndex, 0.0f);
+    return f;
+}
+
+FrameUniformBuffer::~FrameUniformBuffer()
+{
+    destroy();
+}
+
+void FrameUniformBuffer::init()
+{
+    if (m_buffer) return;
+
+    glGenBuffers(1, &m_buffer);
+    gl_state::bindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), &m_data, GL_STREAM_DRAW);
+}
+
+void FrameUniformBuffer::destroy()
+{
+    if (m_buffer) { gl_state::deleteBuffer(m_buffer); m_buffer = 0; }
+    m_data = {};
+}
+
+void FrameUniformBuffer::update(const FrameUniforms& data)
+{
+    init();
+    m_data = data;
+
+    // 288 バイトなので毎回確保し直しても安い（前のフレームが読み終えるのを待たない）
+    gl_state::bindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), &m_data, GL_STREAM_DRAW);
+    bind();
+}
+
+void FrameUniformBuffer::bind() const
+{
+    if (m_buffer) gl_state::bindBufferBase(GL_UNIFORM_BUFFER, kBinding, m_buffer);
+}
+
+void FrameUniformBuffer::bindBlock(GLuint program)
+{
+    const GLuint block = glGetUniformBlockIndex(program, kBlockName);
+    if (block != GL_INVALID_INDEX) glUniformBlockBinding(program, block, kBinding);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "cstdint"
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+/**
+ * @brief フレームごとのカメラ情報（std140 の uniform ブロック "Frame" と同じ並び）
+ *
+ * シェーダ側は line.glsl / solid.glsl / pick.glsl の先頭で同じブロックを宣言している。
+ * mat4 と vec4 だけなので std140 でも詰め物は入らない。
+ */
+struct FrameUniforms
+{
+    glm::mat4 view{ 1.0f };
+    glm::mat4 proj{ 1.0f };
+    glm::mat4 viewProj{ 1.0f };
+    glm::mat4 invViewProj{ 1.0f };
+    glm::vec4 viewport{ 0.0f };     ///< x, y, 幅, 高さ（ピクセル）
+    glm::vec4 time{ 0.0f };         ///< 経過秒, 前フレームからの秒, フレーム番号, 0
+
+    static FrameUniforms make(const glm::mat4& view, const glm::mat4& proj, int w, int h,
+        float seconds = 0.0f, float deltaSeconds = 0.0f, uint32_t frameIndex = 0);
+};
+static_assert(sizeof(FrameUniforms) == 4 * 64 + 2 * 16, "FrameUniforms layout must match the std140 Frame block");
+
+/**
+ * @brief FrameUniforms を入れる uniform バッファ
+ *
+ * update() で丸ごと書き換え（glBufferData で古い中身は捨てる）、kBinding に結び付ける。
+ * 書くのはフレームに 1 回（ピッキングのパスは自分のバッファを一時的に結び付ける）。
+ * プログラム側のブロックは program_registry が作成時に kBinding へつなぐ。
+ */
+class FrameUniformBuffer
+{
+public:
+    static constexpr GLuint kBinding = 0;
+    static constexpr const char* kBlockName = "Frame";
+
+    FrameUniformBuffer() = default;
+    ~FrameUniformBuffer();
+
+    FrameUniformBuffer(const FrameUniformBuffer&) = delete;
+    FrameUniformBuffer& operator=(const FrameUniformBuffer&) = delete;
+
+    void init();
+    void destroy();
+
+    /// 書き込んでから bind() する
+    void update(const FrameUniforms& data);
+    void bind() const;
+
+    const FrameUniforms& data() const { return m_data; }
+
+    /// program に Frame ブロックがあれば kBinding につなぐ（無ければ何もしない）
+    static void bindBlock(GLuint program);
+
+private:
+    GLuint m_buffer = 0;
+    FrameUniforms m_data;
+};
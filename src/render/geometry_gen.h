@@ -1,16 +1,8 @@
 #pragma once
 
-#include "vector"
-
-#include "glm/glm.hpp"
-
-#include "render/vertex.h"
+#include "mesh/edit_mesh.h"
 
 namespace geometry_gen
 {
-	std::vector<Vertex> generateGrid(int half = 10, float step = 1.0f);
-	std::vector<Vertex> generateCubeWire(float s = 0.5f);
-	std::vector<Vertex> createCubeSharedVerts(float s = 0.5f);
-	std::vector<uint32_t> createCubeSharedIndices();
-	std::vector<glm::vec3> generateCubeSolidPositions(float s = 0.5f);
+	EditMesh createCube(float s = 0.5f);
 }
\ No newline at end of file
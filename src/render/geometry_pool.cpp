@@ -0,0 +1,279 @@
+#include "geometry_pool.h"
+
+#include "algorithm"
+#include "stdexcept"
+
+#include "render/gl_state.h"
+
+GeometryPool::~GeometryPool()
+{
+    destroy();
+}
+
+void GeometryPool::init(VertexFormat format, uint32_t vertexCapacity, uint32_t indexCapacity)
+{
+    destroy();
+
+    m_format = format;
+    m_layout = vertex_layout::of(format);
+    m_stride = m_layout.stride;
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+    glGenBuffers(1, &m_ebo);
+
+    gl_state::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertexCapacity * m_stride, nullptr, GL_STATIC_DRAW);
+
+    m_vertexSpace = RangeAllocator(vertexCapacity);
+    m_indexSpace = RangeAllocator(indexCapacity);
+
+    gl_state::bindVertexArray(m_vao);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)indexCapacity * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+
+    setupVertexArray();
+}
+
+void GeometryPool::destroy()
+{
+    if (m_ebo) gl_state::deleteBuffer(m_ebo);
+    if (m_vbo) gl_state::deleteBuffer(m_vbo);
+    if (m_vao) gl_state::deleteVertexArray(m_vao);
+    m_vao = m_vbo = m_ebo = 0;
+
+    m_vertexSpace = RangeAllocator();
+    m_indexSpace = RangeAllocator();
+    m_allocs.clear();
+    m_freeHandles.clear();
+    m_compactions = 0;
+    m_grows = 0;
+}
+
+GeometryPool::Handle GeometryPool::allocateRaw(VertexFormat format, const void* verts, uint32_t vertexCount,
+    std::span<const uint32_t> indices)
+{
+    if (!m_vao) throw std::runtime_error("GeometryPool::allocate called before init");
+    if (format != m_format) throw std::runtime_error("GeometryPool::allocate vertex format mismatch");
+
+    Handle h;
+    if (!m_freeHandles.empty())
+    {
+        h = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+    else
+    {
+        h = (Handle)m_allocs.size();
+        m_allocs.emplace_back();
+    }
+
+    // 先に頂点範囲を live として記録しておく
+    // （インデックス側の確保で compact が走っても、この範囲が空き扱いされないように）
+    {
+        Allocation& a = m_allocs[h];
+        a.vertexOffset = allocateRange(m_vertexSpace, vertexCount, true);
+        a.vertexCount = vertexCount;
+        a.indexOffset = 0;
+        a.indexCount = 0;
+        a.live = true;
+    }
+    const uint32_t indexOffset = allocateRange(m_indexSpace, (uint32_t)indices.size(), false);
+
+    Allocation& a = m_allocs[h];
+    a.indexOffset = indexOffset;
+    a.indexCount = (uint32_t)indices.size();
+
+    if (vertexCount > 0)
+    {
+        gl_state::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)a.vertexOffset * m_stride, (GLsizeiptr)vertexCount * m_stride, verts);
+    }
+    if (!indices.empty())
+    {
+        // EBO のバインドは VAO の状態なので、他の VAO を汚さないよう COPY_WRITE 経由で書く
+        gl_state::bindBuffer(GL_COPY_WRITE_BUFFER, m_ebo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)a.indexOffset * sizeof(uint32_t), indices.size_bytes(), indices.data());
+    }
+    return h;
+}
+
+void GeometryPool::release(Handle h)
+{
+    if (h >= m_allocs.size() || !m_allocs[h].live) return;
+
+    Allocation& a = m_allocs[h];
+    m_vertexSpace.release(a.vertexOffset, a.vertexCount);
+    m_indexSpace.release(a.indexOffset, a.indexCount);
+    a = Allocation{};
+    m_freeHandles.push_back(h);
+}
+
+void GeometryPool::updateVerticesRaw(VertexFormat format, Handle h, uint32_t first, const void* verts, uint32_t count)
+{
+    const Allocation& a = m_allocs[h];
+    if (!a.live || count == 0) return;
+    if (format != m_format) throw std::runtime_error("GeometryPool::updateVertices vertex format mismatch");
+    if (first + count > a.vertexCount)
+        throw std::runtime_error("GeometryPool::updateVertices out of range");
+
+    gl_state::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(a.vertexOffset + first) * m_stride, (GLsizeiptr)count * m_stride, verts);
+}
+
+void GeometryPool::updateIndices(Handle h, uint32_t first, std::span<const uint32_t> indices)
+{
+    const Allocation& a = m_allocs[h];
+    if (!a.live || indices.empty()) return;
+    if (first + indices.size() > a.indexCount)
+        throw std::runtime_error("GeometryPool::updateIndices out of range");
+
+    gl_state::bindBuffer(GL_COPY_WRITE_BUFFER, m_ebo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(a.indexOffset + first) * sizeof(uint32_t), indices.size_bytes(), indices.data());
+}
+
+uint32_t GeometryPool::allocateRange(RangeAllocator& space, uint32_t count, bool vertices)
+{
+    uint32_t offset = space.allocate(count);
+    if (offset != RangeAllocator::kFailed) return offset;
+
+    if (space.freeTotal() >= count)
+    {
+        // 合計は足りる = 断片化。詰め直せば末尾に入る
+        compact();
+    }
+    else
+    {
+        const uint32_t used = space.capacity() - space.freeTotal();
+        const uint32_t newCapacity = std::max(space.capacity() * 2, used + count);
+        if (vertices)
+            reallocate(m_vbo, GL_ARRAY_BUFFER, m_stride, newCapacity, false);
+        else
+            reallocate(m_ebo, GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t), newCapacity, false);
+        space.grow(newCapacity);
+        ++m_grows;
+    }
+
+    offset = space.allocate(count);
+    if (offset == RangeAllocator::kFailed)
+        throw std::runtime_error("GeometryPool failed to allocate after grow/compact");
+    return offset;
+}
+
+void GeometryPool::compact()
+{
+    if (!m_vao) return;
+
+    reallocate(m_vbo, GL_ARRAY_BUFFER, m_stride, m_vertexSpace.capacity(), true);
+    reallocate(m_ebo, GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t), m_indexSpace.capacity(), true);
+    ++m_compactions;
+}
+
+void GeometryPool::reallocate(GLuint& buffer, GLenum target, size_t elementSize, uint32_t newCapacity, bool pack)
+{
+    // 新しいバッファへ GPU 上でコピーする（CPU には読み戻さない）
+    // 同一バッファ内の重なるコピーは未定義なので、詰め直しも別バッファ経由
+    GLuint next = 0;
+    glGenBuffers(1, &next);
+    gl_state::bindBuffer(GL_COPY_WRITE_BUFFER, next);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)newCapacity * elementSize, nullptr, GL_STATIC_DRAW);
+    gl_state::bindBuffer(GL_COPY_READ_BUFFER, buffer);
+
+    const bool vertices = (target == GL_ARRAY_BUFFER);
+    RangeAllocator& space = vertices ? m_vertexSpace : m_indexSpace;
+
+    if (!pack)
+    {
+        const uint32_t oldCapacity = space.capacity();
+        if (oldCapacity > 0)
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)oldCapacity * elementSize);
+    }
+    else
+    {
+        // 現在の offset 順に前へ詰める（相対順序を保つので局所性も崩れない）
+        std::vector<Handle> order;
+        order.reserve(m_allocs.size());
+        for (Handle h = 0; h < (Handle)m_allocs.size(); ++h)
+            if (m_allocs[h].live) order.push_back(h);
+
+        auto offsetOf = [&](Handle h) -> uint32_t& { return vertices ? m_allocs[h].vertexOffset : m_allocs[h].indexOffset; };
+        auto countOf = [&](Handle h) { return vertices ? m_allocs[h].vertexCount : m_allocs[h].indexCount; };
+        std::sort(order.begin(), order.end(), [&](Handle a, Handle b) { return offsetOf(a) < offsetOf(b); });
+
+        uint32_t cursor = 0;
+        for (Handle h : order)
+        {
+            const uint32_t count = countOf(h);
+            if (count == 0) { offsetOf(h) = 0; continue; }
+
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                (GLintptr)offsetOf(h) * elementSize, (GLintptr)cursor * elementSize, (GLsizeiptr)count * elementSize);
+            offsetOf(h) = cursor;
+            cursor += count;
+        }
+        space.resetPacked(cursor);
+    }
+
+    gl_state::deleteBuffer(buffer);
+    buffer = next;
+
+    // VAO が古いバッファを指しているので付け替える
+    if (vertices)
+    {
+        setupVertexArray();
+    }
+    else
+    {
+        gl_state::bindVertexArray(m_vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    }
+}
+
+void GeometryPool::setupVertexArray()
+{
+    gl_state::bindVertexArray(m_vao);
+    gl_state::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    vertex_layout::apply(m_layout);
+}
+
+void GeometryPool::bind() const
+{
+    gl_state::bindVertexArray(m_vao);
+}
+
+void GeometryPool::draw(Handle h, GLenum mode, GLsizei instanceCount) const
+{
+    const Allocation& a = m_allocs[h];
+    if (!a.live || instanceCount <= 0) return;
+
+    if (a.indexCount == 0)
+    {
+        if (a.vertexCount == 0) return;
+        if (instanceCount == 1)
+            glDrawArrays(mode, (GLint)a.vertexOffset, (GLsizei)a.vertexCount);
+        else
+            glDrawArraysInstanced(mode, (GLint)a.vertexOffset, (GLsizei)a.vertexCount, instanceCount);
+        return;
+    }
+
+    void* first = (void*)((size_t)a.indexOffset * sizeof(uint32_t));
+    if (instanceCount == 1)
+        glDrawElementsBaseVertex(mode, (GLsizei)a.indexCount, GL_UNSIGNED_INT, first, (GLint)a.vertexOffset);
+    else
+        glDrawElementsInstancedBaseVertex(mode, (GLsizei)a.indexCount, GL_UNSIGNED_INT, first, instanceCount, (GLint)a.vertexOffset);
+}
+
+GeometryPool::Stats GeometryPool::stats() const
+{
+    Stats s;
+    s.vertexStride = (uint32_t)m_stride;
+    s.vertexCapacity = m_vertexSpace.capacity();
+    s.vertexUsed = s.vertexCapacity - m_vertexSpace.freeTotal();
+    s.indexCapacity = m_indexSpace.capacity();
+    s.indexUsed = s.indexCapacity - m_indexSpace.freeTotal();
+    s.allocations = (uint32_t)(m_allocs.size() - m_freeHandles.size());
+    s.freeBlocks = (uint32_t)(m_vertexSpace.freeBlockCount() + m_indexSpace.freeBlockCount());
+    s.compactions = m_compactions;
+    s.grows = m_grows;
+    return s;
+}
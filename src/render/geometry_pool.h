@@ -0,0 +1,116 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+#include "vector"
+
+#include "glad/glad.h"
+
+#include "render/range_allocator.h"
+#include "render/vertex.h"
+#include "render/vertex_layout.h"
+
+/**
+ * @brief 1 つの頂点形式の頂点・インデックスを大きな VBO / EBO 1 組から部分確保するプール
+ *
+ * VAO もプールで 1 つだけ持つ（形式ごとにプールを分ける。属性は VertexLayout の表から設定）。各メッシュは allocate() で得たハンドルを持ち、
+ * baseVertex 付きの描画（glDrawElementsBaseVertex）で自分の範囲だけを描く。
+ * インデックスはメッシュ内のローカル番号のまま格納するので、
+ * 頂点範囲が動いても（compact / grow）書き換え不要。
+ *
+ * - 空きが足りなければ 2 倍に拡張（glCopyBufferSubData で中身を引き継ぐ）
+ * - 空きの合計は足りるが断片化しているときは compact() で詰め直す
+ * - ハンドルは compact / grow の後も有効
+ *
+ * 描画前に bind() で VAO をバインドしておくこと（メッシュごとのバインドはしない）。
+ */
+class GeometryPool
+{
+public:
+    using Handle = uint32_t;
+    static constexpr Handle kInvalidHandle = 0xFFFFFFFFu;
+
+    struct Stats
+    {
+        uint32_t vertexStride = 0;      ///< バイト
+        uint32_t vertexUsed = 0, vertexCapacity = 0;
+        uint32_t indexUsed = 0, indexCapacity = 0;
+        uint32_t allocations = 0;
+        uint32_t freeBlocks = 0;        ///< 頂点・インデックスの空き区間数の合計（断片化の目安）
+        uint32_t compactions = 0;
+        uint32_t grows = 0;
+    };
+
+    GeometryPool() = default;
+    ~GeometryPool();
+
+    void init(VertexFormat format = VertexFormat::Full,
+        uint32_t vertexCapacity = 1u << 16, uint32_t indexCapacity = 1u << 18);
+    void destroy();
+
+    /**
+     * @brief 頂点（とインデックス）を確保して書き込む
+     *
+     * indices が空なら非インデックス描画（glDrawArrays）用の範囲になる。
+     * V はこのプールの形式（VertexLayout<V>::kFormat）と一致していること。
+     */
+    template <PoolVertex V>
+    Handle allocate(std::span<const V> verts, std::span<const uint32_t> indices = {})
+    {
+        return allocateRaw(VertexLayout<V>::kFormat, verts.data(), (uint32_t)verts.size(), indices);
+    }
+    void release(Handle h);
+
+    /// 確保済み範囲の一部を書き換える（first は区画内の要素番号）
+    template <PoolVertex V>
+    void updateVertices(Handle h, uint32_t first, std::span<const V> verts)
+    {
+        updateVerticesRaw(VertexLayout<V>::kFormat, h, first, verts.data(), (uint32_t)verts.size());
+    }
+    void updateIndices(Handle h, uint32_t first, std::span<const uint32_t> indices);
+
+    /// 断片化した空き区間を詰めて末尾にまとめる
+    void compact();
+
+    void bind() const;
+
+    /// bind() 済みの前提で描く
+    void draw(Handle h, GLenum mode, GLsizei instanceCount = 1) const;
+
+    uint32_t vertexCount(Handle h) const { return m_allocs[h].vertexCount; }
+    uint32_t indexCount(Handle h) const { return m_allocs[h].indexCount; }
+
+    GLuint vao() const { return m_vao; }
+    VertexFormat format() const { return m_format; }
+    Stats stats() const;
+
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+private:
+    struct Allocation
+    {
+        uint32_t vertexOffset = 0, vertexCount = 0;
+        uint32_t indexOffset = 0, indexCount = 0;
+        bool     live = false;
+    };
+
+    GLuint m_vao = 0, m_vbo = 0, m_ebo = 0;
+    VertexFormat m_format = VertexFormat::Full;
+    VertexLayoutView m_layout = vertex_layout::of<Vertex>();
+    size_t m_stride = sizeof(Vertex);
+    RangeAllocator m_vertexSpace;
+    RangeAllocator m_indexSpace;
+
+    std::vector<Allocation> m_allocs;
+    std::vector<Handle>     m_freeHandles;
+
+    uint32_t m_compactions = 0;
+    uint32_t m_grows = 0;
+
+    Handle allocateRaw(VertexFormat format, const void* verts, uint32_t vertexCount, std::span<const uint32_t> indices);
+    void updateVerticesRaw(VertexFormat format, Handle h, uint32_t first, const void* verts, uint32_t count);
+    uint32_t allocateRange(RangeAllocator& space, uint32_t count, bool vertices);
+    void reallocate(GLuint& buffer, GLenum target, size_t elementSize, uint32_t newCapacity, bool pack);
+    void setupVertexArray();
+};
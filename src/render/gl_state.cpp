@@ -0,0 +1,257 @@
+#include "gl_state.h"
+
+#include "array"
+#include "cstddef"
+
+namespace
+{
+    // 不明を表す値（GL の名前・enum としては出てこない）
+    constexpr GLuint kUnknown = 0xFFFFFFFFu;
+
+    // キャッシュする enable の対象。ここに無い cap は毎回そのまま呼ぶ
+    constexpr std::array<GLenum, 6> kCaps = {
+        GL_BLEND, GL_DEPTH_TEST, GL_POLYGON_OFFSET_FILL, GL_CULL_FACE, GL_SCISSOR_TEST, GL_FRAMEBUFFER_SRGB,
+    };
+
+    // キャッシュするバッファのバインド先
+    constexpr std::array<GLenum, 5> kBufferTargets = {
+        GL_ARRAY_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_PIXEL_PACK_BUFFER, GL_UNIFORM_BUFFER,
+    };
+
+    // キャッシュする uniform ブロックのバインディング番号 [0, N)
+    constexpr GLuint kUniformBindings = 4;
+
+    enum class Tri : uint8_t { Unknown, Off, On };
+
+    struct State
+    {
+        GLuint program = kUnknown;
+        GLuint vao = kUnknown;
+        std::array<GLuint, kBufferTargets.size()> buffers;
+        std::array<GLuint, kUniformBindings> uniformBindings;
+        std::array<Tri, kCaps.size()> caps;
+
+        bool   blendKnown = false;
+        GLenum blendSrc = 0, blendDst = 0;
+        bool   offsetKnown = false;
+        float  offsetFactor = 0.0f, offsetUnits = 0.0f;
+        bool   viewportKnown = false;
+        GLint  viewport[4] = {};
+        Tri    depthMask = Tri::Unknown;
+        GLenum depthFunc = kUnknown;
+
+        gl_state::Stats frame;
+        gl_state::Stats last;
+
+        State() { reset(); }
+
+        void reset()
+        {
+            program = kUnknown;
+            vao = kUnknown;
+            buffers.fill(kUnknown);
+            uniformBindings.fill(kUnknown);
+            caps.fill(Tri::Unknown);
+            blendKnown = false;
+            offsetKnown = false;
+            viewportKnown = false;
+            depthMask = Tri::Unknown;
+            depthFunc = kUnknown;
+        }
+    };
+
+    State& state()
+    {
+        static State s;
+        return s;
+    }
+
+    template <size_t N>
+    int indexOf(const std::array<GLenum, N>& table, GLenum value)
+    {
+        for (size_t i = 0; i < N; ++i)
+            if (table[i] == value) return (int)i;
+        return -1;
+    }
+
+    /// @return 呼ぶ必要があるか（カウンタも進める）
+    bool changed(bool differs)
+    {
+        gl_state::Stats& f = state().frame;
+        if (differs) ++f.issued;
+        else ++f.skipped;
+        return differs;
+    }
+}
+
+void gl_state::useProgram(GLuint program)
+{
+    State& s = state();
+    if (!changed(s.program != program)) return;
+    s.program = program;
+    glUseProgram(program);
+}
+
+void gl_state::bindVertexArray(GLuint vao)
+{
+    State& s = state();
+    if (!changed(s.vao != vao)) return;
+    s.vao = vao;
+    glBindVertexArray(vao);
+}
+
+void gl_state::bindBuffer(GLenum target, GLuint buffer)
+{
+    const int i = indexOf(kBufferTargets, target);
+    if (i < 0)
+    {
+        changed(true);
+        glBindBuffer(target, buffer);
+        return;
+    }
+
+    State& s = state();
+    if (!changed(s.buffers[i] != buffer)) return;
+    s.buffers[i] = buffer;
+    glBindBuffer(target, buffer);
+}
+
+void gl_state::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    // glBindBufferBase は汎用のバインド先も書き換える
+    State& s = state();
+    const int i = indexOf(kBufferTargets, target);
+    if (target != GL_UNIFORM_BUFFER || index >= kUniformBindings)
+    {
+        changed(true);
+        if (i >= 0) s.buffers[i] = buffer;
+        glBindBufferBase(target, index, buffer);
+        return;
+    }
+
+    if (!changed(s.uniformBindings[index] != buffer)) return;
+    s.uniformBindings[index] = buffer;
+    s.buffers[i] = buffer;
+    glBindBufferBase(target, index, buffer);
+}
+
+void gl_state::setEnabled(GLenum cap, bool enabled)
+{
+    const int i = indexOf(kCaps, cap);
+    const Tri want = enabled ? Tri::On : Tri::Off;
+    if (i >= 0)
+    {
+        State& s = state();
+        if (!changed(s.caps[i] != want)) return;
+        s.caps[i] = want;
+    }
+    else
+    {
+        changed(true);
+    }
+
+    if (enabled) glEnable(cap);
+    else glDisable(cap);
+}
+
+void gl_state::blendFunc(GLenum src, GLenum dst)
+{
+    State& s = state();
+    if (!changed(!s.blendKnown || s.blendSrc != src || s.blendDst != dst)) return;
+    s.blendKnown = true;
+    s.blendSrc = src;
+    s.blendDst = dst;
+    glBlendFunc(src, dst);
+}
+
+void gl_state::polygonOffset(float factor, float units)
+{
+    State& s = state();
+    if (!changed(!s.offsetKnown || s.offsetFactor != factor || s.offsetUnits != units)) return;
+    s.offsetKnown = true;
+    s.offsetFactor = factor;
+    s.offsetUnits = units;
+    glPolygonOffset(factor, units);
+}
+
+void gl_state::viewport(GLint x, GLint y, GLsizei w, GLsizei h)
+{
+    State& s = state();
+    const bool same = s.viewportKnown &&
+        s.viewport[0] == x && s.viewport[1] == y && s.viewport[2] == w && s.viewport[3] == h;
+    if (!changed(!same)) return;
+    s.viewportKnown = true;
+    s.viewport[0] = x;
+    s.viewport[1] = y;
+    s.viewport[2] = w;
+    s.viewport[3] = h;
+    glViewport(x, y, w, h);
+}
+
+void gl_state::depthMask(bool write)
+{
+    State& s = state();
+    const Tri want = write ? Tri::On : Tri::Off;
+    if (!changed(s.depthMask != want)) return;
+    s.depthMask = want;
+    glDepthMask(write ? GL_TRUE : GL_FALSE);
+}
+
+void gl_state::depthFunc(GLenum func)
+{
+    State& s = state();
+    if (!changed(s.depthFunc != func)) return;
+    s.depthFunc = func;
+    glDepthFunc(func);
+}
+
+void gl_state::deleteProgram(GLuint program)
+{
+    if (!program) return;
+
+    // 現在のプログラムを消しても GL 側では使用中のまま残るので、不明扱いにする
+    State& s = state();
+    if (s.program == program) s.program = kUnknown;
+    glDeleteProgram(program);
+}
+
+void gl_state::deleteVertexArray(GLuint vao)
+{
+    if (!vao) return;
+
+    // バインド中の VAO を消すと 0 に戻る
+    State& s = state();
+    if (s.vao == vao) s.vao = 0;
+    glDeleteVertexArrays(1, &vao);
+}
+
+void gl_state::deleteBuffer(GLuint buffer)
+{
+    if (!buffer) return;
+
+    // バインド中のバッファを消すとそのバインド先は 0 に戻る
+    State& s = state();
+    for (GLuint& b : s.buffers)
+        if (b == buffer) b = 0;
+    for (GLuint& b : s.uniformBindings)
+        if (b == buffer) b = 0;
+    glDeleteBuffers(1, &buffer);
+}
+
+void gl_state::invalidate()
+{
+    state().reset();
+}
+
+void gl_state::beginFrame()
+{
+    State& s = state();
+    s.last = s.frame;
+    s.frame = {};
+    s.reset();
+}
+
+gl_state::Stats gl_state::lastFrame()
+{
+    return state().last;
+}
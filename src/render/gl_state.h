@@ -0,0 +1,60 @@
+#pragma once
+
+#include "cstdint"
+
+#include "glad/glad.h"
+
+/**
+ * @brief GL ステートのキャッシュ（現在値と同じなら GL を呼ばない）
+ *
+ * プログラム・VAO・バッファ（uniform ブロックの番号付きを含む）・enable・ブレンド関数・ポリゴンオフセット・ビューポート・
+ * 深度書き込み / 比較関数を覚えておき、変化したときだけ実際に呼ぶ。
+ * レンダラ側のコードはこれ経由でだけステートを変える（描画後に 0 へ戻す必要も無い）。
+ *
+ * - GL_ELEMENT_ARRAY_BUFFER は VAO の一部なのでキャッシュせず、常にそのまま呼ぶ
+ * - 削除は deleteBuffer() などを使う（名前が再利用されたときに古いバインドを信じないため）
+ * - ImGui など外から GL を触るコードの後は invalidate() で「不明」に戻す
+ *
+ * コンテキストは 1 つだけを想定（メインスレッド専用）。
+ */
+namespace gl_state
+{
+    struct Stats
+    {
+        uint32_t issued = 0;    ///< 実際に GL を呼んだ回数
+        uint32_t skipped = 0;   ///< 現在値と同じだったので省いた回数
+    };
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindBuffer(GLenum target, GLuint buffer);
+    /// GL_UNIFORM_BUFFER の 0〜3 番だけキャッシュする（汎用のバインド先も buffer になる）
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+    void setEnabled(GLenum cap, bool enabled);
+    inline void enable(GLenum cap) { setEnabled(cap, true); }
+    inline void disable(GLenum cap) { setEnabled(cap, false); }
+
+    void blendFunc(GLenum src, GLenum dst);
+    void polygonOffset(float factor, float units);
+    void viewport(GLint x, GLint y, GLsizei w, GLsizei h);
+    void depthMask(bool write);
+    void depthFunc(GLenum func);
+
+    // キャッシュから外してから削除する
+    void deleteProgram(GLuint program);
+    void deleteVertexArray(GLuint vao);
+    void deleteBuffer(GLuint buffer);
+
+    /// すべてを不明扱いにする（次の呼び出しは必ず GL に届く）
+    void invalidate();
+
+    /**
+     * @brief フレームの区切り
+     *
+     * 直前のフレームのカウンタを lastFrame() に移して 0 から数え直す。
+     * 前フレームの最後に ImGui が GL を触っているので invalidate() も行う。
+     */
+    void beginFrame();
+    Stats lastFrame();
+}
@@ -0,0 +1,84 @@
+#include "instance_buffer.h"
+
+#include "cstddef"
+
+#include "render/gl_state.h"
+
+InstanceBuffer::~InstanceBuffer()
+{
+    destroy();
+}
+
+void InstanceBuffer::upload(std::span<const InstanceData> instances)
+{
+    if (!m_vbo) glGenBuffers(1, &m_vbo);
+
+    gl_state::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    if (instances.size() > m_capacity)
+    {
+        // 少し余裕を持たせて、ノード追加のたびに確保し直さないようにする
+        m_capacity = instances.size() + instances.size() / 2;
+        glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW);
+    }
+    if (!instances.empty())
+        glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size_bytes(), instances.data());
+
+    m_count = (GLsizei)instances.size();
+    m_source = m_vbo;
+    m_sourceOffset = 0;
+}
+
+InstanceData* InstanceBuffer::map(StreamBuffer& ring, size_t count)
+{
+    size_t offset = 0;
+    InstanceData* dst = (InstanceData*)ring.map(count * sizeof(InstanceData), sizeof(InstanceData), offset);
+
+    m_count = (GLsizei)count;
+    m_source = ring.buffer();
+    m_sourceOffset = offset;
+    return dst;
+}
+
+void InstanceBuffer::attach(GLuint vao, GLuint firstInstance) const
+{
+    if (!vao || !m_source) return;
+
+    gl_state::bindVertexArray(vao);
+
+    for (GLuint i = 0; i < 4; ++i)
+    {
+        glEnableVertexAttribArray(kModelLocation + i);
+        glVertexAttribDivisor(kModelLocation + i, 1);
+    }
+    glEnableVertexAttribArray(kColorLocation);
+    glVertexAttribDivisor(kColorLocation, 1);
+    glEnableVertexAttribArray(kIdLocation);
+    glVertexAttribDivisor(kIdLocation, 1);
+
+    setFirstInstance(firstInstance);
+}
+
+void InstanceBuffer::setFirstInstance(GLuint firstInstance) const
+{
+    gl_state::bindBuffer(GL_ARRAY_BUFFER, m_source);
+
+    const GLsizei stride = sizeof(InstanceData);
+    const size_t base = m_sourceOffset + (size_t)firstInstance * sizeof(InstanceData);
+    for (GLuint i = 0; i < 4; ++i)
+    {
+        glVertexAttribPointer(kModelLocation + i, 4, GL_FLOAT, GL_FALSE, stride,
+            (void*)(base + offsetof(InstanceData, model) + i * sizeof(glm::vec4)));
+    }
+    glVertexAttribPointer(kColorLocation, 4, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(InstanceData, color)));
+    glVertexAttribIPointer(kIdLocation, 1, GL_UNSIGNED_INT, stride, (void*)(base + offsetof(InstanceData, id)));
+}
+
+void InstanceBuffer::destroy()
+{
+    if (m_vbo) gl_state::deleteBuffer(m_vbo);
+    m_vbo = 0;
+    m_count = 0;
+    m_source = 0;
+    m_sourceOffset = 0;
+    m_capacity = 0;
+}
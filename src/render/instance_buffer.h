@@ -0,0 +1,68 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "render/stream_buffer.h"
+
+/// 1 インスタンス分の属性（16 バイト境界に揃えて 96 バイト）
+struct InstanceData
+{
+    glm::mat4 model;
+    glm::vec4 color;
+    uint32_t  id;           ///< ピッキング用（0 = 何も無い）
+    uint32_t  pad[3];
+};
+
+static_assert(sizeof(InstanceData) == 96, "InstanceData layout must match the vertex attribute setup");
+
+/**
+ * @brief インスタンス属性用の VBO
+ *
+ * attach() で任意の VAO に divisor = 1 の属性として登録する。
+ *   location 2..5 : mat4 aModel
+ *   location 6    : vec4 aInstanceColor
+ *   location 7    : uint aInstanceID
+ * 同じバッファを複数の VAO（線・面・ピッキング用）から参照できる。
+ *
+ * 全メッシュのインスタンスを 1 本に連結して持ち、メッシュごとの範囲は
+ * setFirstInstance() で属性の先頭 offset をずらして選ぶ
+ * （GL 3.3 には baseInstance 付きの描画が無いため）。
+ *
+ * 毎フレーム変わる場合（カリング時）は map() で StreamBuffer の区画へ直接書き、
+ * 属性の参照先をそちらへ切り替える。
+ */
+class InstanceBuffer
+{
+public:
+    static constexpr GLuint kModelLocation = 2;
+    static constexpr GLuint kColorLocation = 6;
+    static constexpr GLuint kIdLocation = 7;
+
+    GLuint  m_vbo = 0;
+    GLsizei m_count = 0;
+
+    ~InstanceBuffer();
+
+    /// 容量が足りるうちは glBufferSubData、超えたら確保し直す
+    void upload(std::span<const InstanceData> instances);
+
+    /// ストリームの今フレーム区画に count 個分をマップする（書き終えたら ring.unmap()）
+    InstanceData* map(StreamBuffer& ring, size_t count);
+
+    void attach(GLuint vao, GLuint firstInstance = 0) const;
+
+    /// バインド中の VAO のインスタンス属性を firstInstance 番目から読むように付け替える
+    void setFirstInstance(GLuint firstInstance) const;
+    void destroy();
+
+private:
+    size_t m_capacity = 0;     ///< インスタンス数
+
+    // 属性の参照先（upload() なら m_vbo、map() ならストリーム）
+    GLuint m_source = 0;
+    size_t m_sourceOffset = 0;
+};
@@ -1,20 +1,148 @@
 #pragma once
 
+#include "algorithm"
+#include "concepts"
+#include "span"
+#include "stdexcept"
 #include "vector"
 
 #include "glad/glad.h"
 
+#include "render/dirty_ranges.h"
+#include "render/geometry_pool.h"
 #include "render/vertex.h"
+#include "render/vertex_layout.h"
+#include "render/vertex_pack.h"
 
-class Mesh
+/**
+ * @brief GeometryPool の 1 区画を描く部分（頂点型に依存しない）
+ *
+ * 自前の VAO / VBO は持たない。描画前に pool.bind() しておくこと。
+ */
+class MeshBase
 {
 public:
-	GLuint m_vao = 0, m_vbo = 0, m_ebo = 0;
-	GLsizei m_indexCount = 0;
+    GeometryPool* m_pool = nullptr;
+    GeometryPool::Handle m_handle = GeometryPool::kInvalidHandle;
+    GLenum  m_primitive = GL_TRIANGLES;
+    GLsizei m_vertexCount = 0;
+    GLsizei m_indexCount = 0;    ///< 0 ならインデックス無し（glDrawArrays）
+    vertex_pack::Dequantize m_dequant;    ///< Quantized のときだけ恒等以外（シェーダの uPosScale / uPosBias）
 
-	~Mesh();
+    bool empty() const { return m_vertexCount == 0; }
+    VertexFormat format() const { return m_pool ? m_pool->format() : VertexFormat::Full; }
 
-	void upload(const std::vector<Vertex>& verts, const std::vector<uint32_t>& indices);
-	void draw() const;
-	void destroy();
-};
\ No newline at end of file
+    void draw() const;
+    void drawInstanced(GLsizei instanceCount) const;
+
+protected:
+    MeshBase() = default;
+    ~MeshBase() = default;
+
+    void release();
+};
+
+/**
+ * @brief 頂点型 V のメッシュ
+ *
+ * 属性の設定は VertexLayout<V> の表でプール側が行うので、型ごとのアップロードコードは持たない。
+ * uploadEditable() で作ったものは CPU 側に写しを持ち、
+ * setVertices() などの変更を範囲として溜めて flush() でまとめて送る。
+ */
+template <PoolVertex V>
+class Mesh : public MeshBase
+{
+public:
+    Mesh() = default;
+    ~Mesh() { destroy(); }
+
+    // span なので std::vector もメモリマップした領域もコピー無しで渡せる
+    // indices が空なら非インデックス描画（線分リストなど）
+    void upload(GeometryPool& pool, std::span<const V> verts, std::span<const uint32_t> indices = {},
+        GLenum primitive = GL_TRIANGLES)
+    {
+        destroy();
+
+        m_pool = &pool;
+        m_handle = pool.allocate(verts, indices);
+        m_primitive = primitive;
+        m_vertexCount = (GLsizei)verts.size();
+        m_indexCount = (GLsizei)indices.size();
+    }
+
+    /// 部分更新できるように CPU 側へ写しを残す（頂点数・インデックス数は以後固定）
+    void uploadEditable(GeometryPool& pool, std::span<const V> verts, std::span<const uint32_t> indices = {},
+        GLenum primitive = GL_TRIANGLES)
+    {
+        upload(pool, verts, indices, primitive);
+
+        m_editable = true;
+        m_vertices.assign(verts.begin(), verts.end());
+        m_indices.assign(indices.begin(), indices.end());
+    }
+    bool editable() const { return m_editable; }
+
+    void setPosition(uint32_t v, const glm::vec3& p)
+        requires requires(V& x) { x.position = p; }
+    {
+        requireEditable();
+        m_vertices.at(v).position = p;
+        m_dirtyVertices.add(v, 1);
+    }
+
+    void setVertices(uint32_t first, std::span<const V> verts)
+    {
+        requireEditable();
+        if (first + verts.size() > m_vertices.size()) throw std::runtime_error("Mesh::setVertices out of range");
+
+        std::copy(verts.begin(), verts.end(), m_vertices.begin() + first);
+        m_dirtyVertices.add(first, (uint32_t)verts.size());
+    }
+
+    void setIndices(uint32_t first, std::span<const uint32_t> indices)
+    {
+        requireEditable();
+        if (first + indices.size() > m_indices.size()) throw std::runtime_error("Mesh::setIndices out of range");
+
+        std::copy(indices.begin(), indices.end(), m_indices.begin() + first);
+        m_dirtyIndices.add(first, (uint32_t)indices.size());
+    }
+
+    /// 溜まった変更を glBufferSubData で送る（1 フレーム 1 回）。@return 送ったバイト数
+    size_t flush()
+    {
+        if (!m_pool) return 0;
+
+        size_t bytes = m_dirtyVertices.flush(std::span<const V>(m_vertices),
+            [&](uint32_t first, std::span<const V> part) { m_pool->updateVertices(m_handle, first, part); });
+        bytes += m_dirtyIndices.flush(std::span<const uint32_t>(m_indices),
+            [&](uint32_t first, std::span<const uint32_t> part) { m_pool->updateIndices(m_handle, first, part); });
+        return bytes;
+    }
+
+    void destroy()
+    {
+        release();
+
+        m_editable = false;
+        m_vertices.clear();
+        m_indices.clear();
+        m_dirtyVertices.clear();
+        m_dirtyIndices.clear();
+    }
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+private:
+    bool m_editable = false;
+    std::vector<V>        m_vertices;
+    std::vector<uint32_t> m_indices;
+    DirtyRanges m_dirtyVertices;
+    DirtyRanges m_dirtyIndices;
+
+    void requireEditable() const
+    {
+        if (!m_editable) throw std::runtime_error("Mesh edits require uploadEditable");
+    }
+};
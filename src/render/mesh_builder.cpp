@@ -0,0 +1,112 @@
+#include "render/mesh_builder.h"
+
+void mesh_builder::buildTriangles(
+    const EditMesh& mesh,
+    const glm::vec4& color,
+    std::vector<Vertex>& outVerts,
+    std::vector<uint32_t>& outIndices)
+{
+    outVerts.clear();
+    outIndices.clear();
+
+    outVerts.reserve(mesh.vertexCount());
+    for (const glm::vec3& p : mesh.positions())
+        outVerts.push_back({ p, color });
+
+    // n 角形 → (n - 2) 三角形、半辺数 = Σn なので上限は半辺数 * 3
+    outIndices.reserve((size_t)mesh.halfEdgeCount() * 3);
+    for (uint32_t f = 0; f < mesh.faceCount(); ++f)
+    {
+        const uint32_t he0 = mesh.faceHalfEdge(f);
+        const uint32_t v0 = mesh.vertex(he0);
+
+        for (uint32_t he = mesh.next(he0); mesh.next(he) != he0; he = mesh.next(he))
+        {
+            outIndices.push_back(v0);
+            outIndices.push_back(mesh.vertex(he));
+            outIndices.push_back(mesh.destVertex(he));
+        }
+    }
+}
+
+std::vector<Vertex> mesh_builder::buildEdgeLines(const EditMesh& mesh, const glm::vec4& color,
+    std::vector<uint32_t>* outSource)
+{
+    std::vector<Vertex> lines;
+    lines.reserve((size_t)mesh.edgeCount() * 2);
+    if (outSource)
+    {
+        outSource->clear();
+        outSource->reserve((size_t)mesh.edgeCount() * 2);
+    }
+
+    for (uint32_t he = 0; he < mesh.halfEdgeCount(); ++he)
+    {
+        if (!mesh.isEdgeRepresentative(he)) continue;
+
+        const uint32_t a = mesh.vertex(he);
+        const uint32_t b = mesh.destVertex(he);
+        lines.push_back({ mesh.position(a), color });
+        lines.push_back({ mesh.position(b), color });
+        if (outSource)
+        {
+            outSource->push_back(a);
+            outSource->push_back(b);
+        }
+    }
+    return lines;
+}
+
+FaceTriangles mesh_builder::buildFaceTriangles(const EditMesh& mesh, std::vector<uint32_t>* outSource)
+{
+    FaceTriangles out;
+    out.positions.reserve((size_t)mesh.halfEdgeCount() * 3);
+    out.faceFirst.reserve((size_t)mesh.faceCount() + 1);
+    if (outSource)
+    {
+        outSource->clear();
+        outSource->reserve((size_t)mesh.halfEdgeCount() * 3);
+    }
+
+    for (uint32_t f = 0; f < mesh.faceCount(); ++f)
+    {
+        out.faceFirst.push_back((uint32_t)out.positions.size());
+
+        const uint32_t he0 = mesh.faceHalfEdge(f);
+        const uint32_t v0 = mesh.vertex(he0);
+
+        for (uint32_t he = mesh.next(he0); mesh.next(he) != he0; he = mesh.next(he))
+        {
+            const uint32_t v1 = mesh.vertex(he);
+            const uint32_t v2 = mesh.destVertex(he);
+            out.positions.push_back(mesh.position(v0));
+            out.positions.push_back(mesh.position(v1));
+            out.positions.push_back(mesh.position(v2));
+            if (outSource)
+            {
+                outSource->push_back(v0);
+                outSource->push_back(v1);
+                outSource->push_back(v2);
+            }
+        }
+    }
+    out.faceFirst.push_back((uint32_t)out.positions.size());
+    return out;
+}
+
+VertexSlots mesh_builder::invertSource(std::span<const uint32_t> source, uint32_t vertexCount)
+{
+    // 計数ソート（スロットは頂点ごとに昇順に並ぶので、書き戻しも前から順に進む）
+    VertexSlots out;
+    out.first.assign((size_t)vertexCount + 1, 0);
+    for (uint32_t v : source)
+        ++out.first[v + 1];
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        out.first[v + 1] += out.first[v];
+
+    out.slots.resize(source.size());
+    std::vector<uint32_t> cursor(out.first.begin(), out.first.end() - 1);
+    for (uint32_t slot = 0; slot < (uint32_t)source.size(); ++slot)
+        out.slots[cursor[source[slot]]++] = slot;
+    return out;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "span"
+#include "vector"
+
+#include "glm/glm.hpp"
+
+#include "mesh/edit_mesh.h"
+#include "render/vertex.h"
+
+// 面ごとにまとめた三角形列（面 f の頂点は positions[faceFirst[f] .. faceFirst[f + 1])）
+struct FaceTriangles
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t>  faceFirst;   ///< faceCount + 1 個の累積オフセット
+};
+
+// 元の頂点番号 → 生成した頂点列の位置（スロット）の逆引き（CSR）
+// 頂点 v のスロットは slots[first[v] .. first[v + 1])
+struct VertexSlots
+{
+    std::vector<uint32_t> first;
+    std::vector<uint32_t> slots;
+};
+
+// EditMesh から GPU 用の頂点列を組み立てる
+namespace mesh_builder
+{
+    // 頂点共有 + EBO（面はファン分割）
+    void buildTriangles(
+        const EditMesh& mesh,
+        const glm::vec4& color,
+        std::vector<Vertex>& outVerts,
+        std::vector<uint32_t>& outIndices);
+
+    // 各辺 1 本ずつの GL_LINES 用頂点列
+    // outSource を渡すと、出力頂点ごとの元の頂点番号も返す（部分更新の逆引き用）
+    std::vector<Vertex> buildEdgeLines(const EditMesh& mesh, const glm::vec4& color,
+        std::vector<uint32_t>* outSource = nullptr);
+
+    // ピッキング / ハイライト用（面 ID ごとに連続した非共有三角形）
+    FaceTriangles buildFaceTriangles(const EditMesh& mesh, std::vector<uint32_t>* outSource = nullptr);
+
+    // 出力頂点ごとの元の頂点番号から逆引き表を作る
+    VertexSlots invertSource(std::span<const uint32_t> source, uint32_t vertexCount);
+}
@@ -1,9 +1,17 @@
 #include "picker.h"
 
+#include "algorithm"
+#include "chrono"
+#include "cmath"
+#include "cstring"
+
 #include "imgui.h"
-#include "glm/gtc/type_ptr.hpp"
+#include "glm/gtc/matrix_transform.hpp"
 
-#include "render/shader_utils.h"
+#include "render/gl_state.h"
+#include "render/program_registry.h"
+#include "select/id_reduce.h"
+#include "select/region_faces.h"
 
 Picker::Picker() = default;
 
@@ -12,13 +20,21 @@ Picker::~Picker()
     destroy();
 }
 
-void Picker::init(GLFWwindow* window, GLuint cubeSolidVAO)
+void Picker::init(GLFWwindow* window, const Renderer* renderer)
 {
     m_window = window;
-    m_cubeSolidVAO = cubeSolidVAO;
+    m_renderer = renderer;
+    m_faceMesh = &renderer->faceMesh();
     createShader();
 }
 
+void Picker::setMesh(const EditMesh& mesh)
+{
+    m_mesh = &mesh;
+    m_bvh.clear();
+    m_bvhStale = true;
+}
+
 bool Picker::isReady() const
 {
     return m_prog != 0;
@@ -52,7 +68,19 @@ uint32_t Picker::pick(const glm::mat4& vp, int fbW, int fbH)
     if (!m_pickRequested) return 0;
 
     m_pickRequested = false;
-    return doPicking(vp, fbW, fbH, m_pickX, m_pickY);
+    return pickAt(vp, fbW, fbH, m_pickX, m_pickY);
+}
+
+uint32_t Picker::pickAt(const glm::mat4& vp, int fbW, int fbH, double x, double y)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    const uint32_t id = (m_mode == PickMode::CpuBvh && m_target == PickTarget::Faces)
+        ? doPickingCpu(vp, fbW, fbH, x, y)
+        : doPicking(vp, fbW, fbH, x, y);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    m_lastPickMicros = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    return id;
 }
 
 void Picker::destroy()
@@ -61,18 +89,30 @@ void Picker::destroy()
     if (m_tex) { glDeleteTextures(1, &m_tex); m_tex = 0; }
     if (m_FBO) { glDeleteFramebuffers(1, &m_FBO); m_FBO = 0; }
 
-    if (m_prog) { glDeleteProgram(m_prog); m_prog = 0; }
-    m_locMVP = -1;
-    m_locID = -1;
+    program_registry::release(m_prog);
+    m_prog = 0;
+
+    program_registry::release(m_instProg);
+    m_instProg = 0;
+    m_instLocPosScale = -1;
+    m_instLocPosBias = -1;
 
     m_pickW = 0; m_pickH = 0;
+
+    m_passFrame.destroy();
+    destroyAsync();
+    m_bvh.clear();
+    m_bvhStale = false;
+    m_mesh = nullptr;
 }
 
 void Picker::createShader()
 {
-    m_prog = shader_utils::BuildProgramFromGLSLFile("assets/shaders/pick.glsl");
-    m_locMVP = shader_utils::GetUniformOrThrow(m_prog, "uMVP");
-    m_locID = shader_utils::GetUniformOrThrow(m_prog, "uID");
+    m_prog = program_registry::acquire("assets/shaders/pick.glsl");
+
+    m_instProg = program_registry::acquire("assets/shaders/pick.glsl", "#define INSTANCED 1");
+    m_instLocPosScale = glGetUniformLocation(m_instProg, "uPosScale");
+    m_instLocPosBias = glGetUniformLocation(m_instProg, "uPosBias");
 }
 
 void Picker::ensureFBO(int w, int h)
@@ -110,49 +150,289 @@ void Picker::ensureFBO(int w, int h)
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-uint32_t Picker::doPicking(const glm::mat4& vp, int fbW, int fbH, double mouseX, double mouseY)
+bool Picker::toPixel(int fbW, int fbH, double mouseX, double mouseY, int& px, int& py)
 {
-    ensureFBO(fbW, fbH);
-
     // 範囲外ガード（DPI/ウィンドウ外クリック対策）
-    int px = (int)mouseX;
-    int py = fbH - 1 - (int)mouseY;
-    if (px < 0 || px >= fbW || py < 0 || py >= fbH)
-        return 0;
+    px = (int)mouseX;
+    py = fbH - 1 - (int)mouseY;
+    return !(mouseX < 0.0 || mouseY < 0.0 || px < 0 || px >= fbW || py < 0 || py >= fbH);
+}
 
+bool Picker::beginIdPass(const glm::mat4& vp, int fbW, int fbH, int px, int py, int& readX, int& readY)
+{
+    if (!m_faceMesh) return false;
+
+    if (!m_localPick)
+    {
+        ensureFBO(fbW, fbH);
+        readX = px;
+        readY = py;
+        renderIdPass(vp, fbW, fbH, m_target);
+        return true;
+    }
+
+    // カーソル周辺 N×N だけを描く。
+    // pickMatrix で該当ピクセル領域を NDC 全体に引き伸ばすので、
+    // 塗りつぶしコストとターゲットのメモリはウィンドウサイズに依存しない
+    const int n = m_localSize;
+    ensureFBO(n, n);
+
+    const glm::mat4 pick = glm::pickMatrix(
+        glm::vec2((float)px + 0.5f, (float)py + 0.5f),
+        glm::vec2((float)n, (float)n),
+        glm::ivec4(0, 0, fbW, fbH));
+
+    readX = n / 2;
+    readY = n / 2;
+    renderIdPass(pick * vp, n, n, m_target);
+    return true;
+}
+
+void Picker::renderIdPass(const glm::mat4& vp, int w, int h, PickTarget target)
+{
     glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-    glViewport(0, 0, fbW, fbH);
+    gl_state::viewport(0, 0, w, h);
 
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
+    gl_state::disable(GL_BLEND);
+    gl_state::enable(GL_DEPTH_TEST);
+    gl_state::depthMask(true);
 
     GLuint clearID = 0;
     glClearBufferuiv(GL_COLOR, 0, &clearID);
     glClear(GL_DEPTH_BUFFER_BIT);
 
-    glUseProgram(m_prog);
-    glUniformMatrix4fv(m_locMVP, 1, GL_FALSE, glm::value_ptr(vp));
-
-    glBindVertexArray(m_cubeSolidVAO);
+    // カメラ以外（時間など）はフレームのものをそのまま使い、VP だけパスの行列にする
+    FrameUniforms frame = m_renderer->frameUniforms();
+    frame.viewProj = vp;
+    frame.invViewProj = glm::inverse(vp);
+    frame.viewport = glm::vec4(0.0f, 0.0f, (float)w, (float)h);
+    m_passFrame.update(frame);
 
-    for (uint32_t face = 0; face < 6; ++face)
+    if (target == PickTarget::Objects)
     {
-        glUniform1ui(m_locID, face + 1);
-        glDrawArrays(GL_TRIANGLES, (GLint)(face * 6), 6);
+        // ノード ID = node + 1 はインスタンス属性に入っているので 1 メッシュ 1 回で済む
+        gl_state::useProgram(m_instProg);
+        m_renderer->drawInstancedSolids(m_instLocPosScale, m_instLocPosBias);
+    }
+    else
+    {
+        // 面 ID = face + 1 は FaceMesh の頂点属性に入っているので全面を 1 回で描く
+        gl_state::useProgram(m_prog);
+        m_faceMesh->draw();
     }
 
-    glBindVertexArray(0);
-    glUseProgram(0);
-
-    uint32_t out = 0;
     glReadBuffer(GL_COLOR_ATTACHMENT0);
-    glReadPixels(px, py, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, &out);
+}
 
+void Picker::endIdPass()
+{
+    // ブレンド・深度は Renderer::draw が必要な値に戻す（ここで戻すと毎回 2 回ずつ切り替わる）
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_renderer->bindFrameUniforms();
+}
 
-    // 通常描画に戻す（最低限）
-    glEnable(GL_BLEND);
+uint32_t Picker::doPicking(const glm::mat4& vp, int fbW, int fbH, double mouseX, double mouseY)
+{
+    int px = 0, py = 0;
+    if (!toPixel(fbW, fbH, mouseX, mouseY, px, py))
+        return 0;
+
+    int readX = 0, readY = 0;
+    if (!beginIdPass(vp, fbW, fbH, px, py, readX, readY))
+        return 0;
+
+    uint32_t out = 0;
+    glReadPixels(readX, readY, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, &out);
+
+    endIdPass();
 
     return out;
 }
+
+std::vector<uint32_t> Picker::pickRegion(const glm::mat4& vp, int fbW, int fbH, const ScreenRegion& region, bool occluded)
+{
+    std::vector<uint32_t> out;
+    if (!m_faceMesh) return out;
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // ウィンドウ内に切り詰めたピクセル範囲 [x0, x1) x [y0, y1)（ウィンドウ座標）
+    const int x0 = std::max(0, (int)std::floor(region.min.x));
+    const int y0 = std::max(0, (int)std::floor(region.min.y));
+    const int x1 = std::min(fbW, (int)std::ceil(region.max.x));
+    const int y1 = std::min(fbH, (int)std::ceil(region.max.y));
+    const int w = x1 - x0;
+    const int h = y1 - y0;
+    if (w <= 0 || h <= 0) return out;
+
+    if (occluded)
+    {
+        // 隠れた面・重なった面は ID バッファに残らないので、描かずに CPU で投影して調べる
+        if (m_mesh)
+        {
+            region_faces::collect(*m_mesh, vp, fbW, fbH, glm::vec2((float)x0, (float)y0), glm::vec2((float)x1, (float)y1),
+                region.lasso, out);
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        m_lastRegionMillis = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        return out;
+    }
+
+    // GL 座標（左下原点）での範囲下端
+    const int glY0 = fbH - y1;
+
+    ensureFBO(w, h);
+    const glm::mat4 pick = glm::pickMatrix(
+        glm::vec2((float)x0 + 0.5f * w, (float)glY0 + 0.5f * h),
+        glm::vec2((float)w, (float)h),
+        glm::ivec4(0, 0, fbW, fbH));
+
+    renderIdPass(pick * vp, w, h, PickTarget::Faces);
+
+    m_regionIds.resize((size_t)w * h);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, w, h, GL_RED_INTEGER, GL_UNSIGNED_INT, m_regionIds.data());
+
+    endIdPass();
+
+    if (!region.lasso.empty())
+    {
+        // 読み出しは下の行から。行 r の中心がウィンドウ座標 y1 - r - 0.5 になるよう変換
+        std::vector<glm::vec2> local;
+        local.reserve(region.lasso.size());
+        for (const glm::vec2& p : region.lasso)
+            local.emplace_back(p.x - (float)x0, (float)y1 - p.y);
+
+        id_reduce::maskOutsidePolygon(m_regionIds, w, h, local);
+    }
+
+    id_reduce::collectUniqueIds(m_regionIds, m_faceMesh->faceCount(), out);
+
+    const auto t1 = std::chrono::steady_clock::now();
+    m_lastRegionMillis = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    return out;
+}
+
+void Picker::updateHover(const glm::mat4& vp, int fbW, int fbH)
+{
+    if (!m_window) return;
+
+    // ImGui上ではハイライトしない（読み出し中の結果も捨てる）
+    double mx = 0.0, my = 0.0;
+    glfwGetCursorPos(m_window, &mx, &my);
+    int px = 0, py = 0;
+    const bool inside = toPixel(fbW, fbH, mx, my, px, py) && !ImGui::GetIO().WantCaptureMouse;
+
+    if (m_mode == PickMode::CpuBvh && m_target == PickTarget::Faces)
+    {
+        m_hoveredId = inside ? doPickingCpu(vp, fbW, fbH, mx, my) : 0;
+        return;
+    }
+
+    pollAsync();
+
+    if (!inside)
+    {
+        m_hoveredId = 0;
+        return;
+    }
+
+    issueAsync(vp, fbW, fbH, px, py);
+}
+
+void Picker::ensureAsync()
+{
+    if (m_async[0].pbo) return;
+
+    for (AsyncSlot& slot : m_async)
+    {
+        glGenBuffers(1, &slot.pbo);
+        gl_state::bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(uint32_t), nullptr, GL_STREAM_READ);
+    }
+    gl_state::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void Picker::issueAsync(const glm::mat4& vp, int fbW, int fbH, int px, int py)
+{
+    // リングが埋まっている = GPU が 3 フレーム遅れている。待たずにこのフレームは諦める
+    if (m_asyncCount == kAsyncSlots) return;
+
+    ensureAsync();
+
+    int readX = 0, readY = 0;
+    if (!beginIdPass(vp, fbW, fbH, px, py, readX, readY))
+        return;
+
+    // PBO を束縛した状態の glReadPixels はオフセット指定になり、CPU は待たない
+    AsyncSlot& slot = m_async[m_asyncHead];
+    gl_state::bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glReadPixels(readX, readY, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    gl_state::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    endIdPass();
+
+    m_asyncHead = (m_asyncHead + 1) % kAsyncSlots;
+    ++m_asyncCount;
+}
+
+void Picker::pollAsync()
+{
+    // 古い順に、GPU が終わっているものだけ回収する（最後に回収したものが最新）
+    while (m_asyncCount > 0)
+    {
+        AsyncSlot& slot = m_async[m_asyncTail];
+
+        // タイムアウト 0 = 問い合わせのみ。fence は SwapBuffers でフラッシュされる
+        const GLenum r = glClientWaitSync(slot.fence, 0, 0);
+        if (r == GL_TIMEOUT_EXPIRED) break;
+
+        if (r != GL_WAIT_FAILED)
+        {
+            gl_state::bindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            if (const void* p = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(uint32_t), GL_MAP_READ_BIT))
+            {
+                std::memcpy(&m_hoveredId, p, sizeof(uint32_t));
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            gl_state::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        m_asyncTail = (m_asyncTail + 1) % kAsyncSlots;
+        --m_asyncCount;
+    }
+}
+
+void Picker::destroyAsync()
+{
+    for (AsyncSlot& slot : m_async)
+    {
+        if (slot.fence) { glDeleteSync(slot.fence); slot.fence = nullptr; }
+        if (slot.pbo) { gl_state::deleteBuffer(slot.pbo); slot.pbo = 0; }
+    }
+    m_asyncHead = m_asyncTail = m_asyncCount = 0;
+    m_hoveredId = 0;
+}
+
+uint32_t Picker::doPickingCpu(const glm::mat4& vp, int fbW, int fbH, double mouseX, double mouseY) const
+{
+    // 範囲外ガードは ID バッファ方式と同じ
+    if (mouseX < 0.0 || mouseX >= fbW || mouseY < 0.0 || mouseY >= fbH)
+        return 0;
+
+    if (m_bvhStale && m_mesh)
+    {
+        m_bvh.build(*m_mesh);
+        m_bvhStale = false;
+    }
+
+    const Ray ray = Ray::fromScreen(glm::inverse(vp), mouseX, mouseY, fbW, fbH);
+
+    RayHit hit;
+    return m_bvh.raycast(ray, hit) ? hit.faceId : 0;
+}
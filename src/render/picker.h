@@ -5,41 +5,149 @@
 #include "GLFW/glfw3.h"
 #include "glm/glm.hpp"
 
+#include "mesh/bvh.h"
+#include "mesh/edit_mesh.h"
+#include "render/face_mesh.h"
+#include "render/frame_uniforms.h"
+#include "render/renderer.h"
+#include "select/region_select_tool.h"
+
+enum class PickMode
+{
+    GpuIdBuffer,    ///< ID バッファを描画して glReadPixels
+    CpuBvh,         ///< BVH レイキャスト（GPU 同期なし）
+};
+
+enum class PickTarget
+{
+    Faces,          ///< 編集メッシュの面（ID = face + 1）
+    Objects,        ///< シーンのノード（ID = node + 1、インスタンス描画で ID を書く）
+};
+
 class Picker
 {
 public:
     Picker();
     ~Picker();
 
-    void init(GLFWwindow* window, GLuint cubeSolidVAO);
+    void init(GLFWwindow* window, const Renderer* renderer);
+    /// mesh は範囲選択（occluded）と BVH の構築で参照するので、Picker より長く生かしておくこと
+    /// BVH は CPU モードで初めてピックするときに作る（読み込み・編集のたびには作らない）
+    void setMesh(const EditMesh& mesh);
     bool isReady() const;
     void updateRequest();
     bool hasRequest() const;
     uint32_t pick(const glm::mat4& vp, int fbW, int fbH);
+
+    /// 要求の有無に関係なく、ウィンドウ座標 (x, y) をその場で引く（ベンチマーク・スクリプト用）
+    uint32_t pickAt(const glm::mat4& vp, int fbW, int fbH, double x, double y);
+
+    /**
+     * @brief 矩形 / 投げ縄範囲内の面 ID をすべて集める
+     *
+     * @param occluded true なら隠れた面も拾う
+     * @return 昇順・重複なしの面 ID
+     *
+     * 見える面だけなら、範囲だけを pickMatrix で描いて一括で読み出し、id_reduce で集合にする。
+     * ID バッファは 1 ピクセルに 1 面しか残せないので、occluded のときは描かずに
+     * region_faces で全面を CPU で投影して範囲との重なりを調べる。
+     */
+    std::vector<uint32_t> pickRegion(const glm::mat4& vp, int fbW, int fbH, const ScreenRegion& region, bool occluded);
+    double lastRegionMillis() const { return m_lastRegionMillis; }
+
+    // カーソル下の面（Objects ならノード）を毎フレーム更新する（GPU モードは PBO + fence で 1〜2 フレーム遅れ）
+    void updateHover(const glm::mat4& vp, int fbW, int fbH);
+    uint32_t hoveredId() const { return m_hoveredId; }
     void destroy();
 
+    void setMode(PickMode mode) { m_mode = mode; }
+    PickMode mode() const { return m_mode; }
+
+    /**
+     * @brief pick() / updateHover() の対象
+     *
+     * Objects のときは vp にワールドの VP を渡す（Faces は編集メッシュの MVP）。
+     * Objects は ID バッファのみ（CpuBvh でも GPU で引く）。
+     * 範囲選択（pickRegion）は常に面。
+     */
+    void setTarget(PickTarget target)
+    {
+        if (target != m_target) m_hoveredId = 0;
+        m_target = target;
+    }
+    PickTarget target() const { return m_target; }
+
+    // ID バッファをカーソル周辺 N×N だけ描くか（false ならウィンドウ全体）
+    void setLocalPick(bool enable) { m_localPick = enable; }
+    bool localPick() const { return m_localPick; }
+    int pickTargetWidth() const { return m_pickW; }
+    int pickTargetHeight() const { return m_pickH; }
+    double lastPickMicros() const { return m_lastPickMicros; }
+
     Picker(const Picker&) = delete;
     Picker& operator=(const Picker&) = delete;
 
 private:
     GLFWwindow* m_window = nullptr;
-    GLuint m_cubeSolidVAO = 0;
+    const Renderer* m_renderer = nullptr;
+    const FaceMesh* m_faceMesh = nullptr;
+    const EditMesh* m_mesh = nullptr;
 
     GLuint m_FBO = 0;
     GLuint m_tex = 0;
     GLuint m_depth = 0;
     int m_pickW = 0, m_pickH = 0;
 
-    GLuint m_prog = 0;
-    GLint  m_locMVP = -1;
-    GLint  m_locID = -1;
+    bool m_localPick = true;
+    int  m_localSize = 3;       ///< カーソル周辺の描画範囲（奇数、中心を読む）
+
+    FrameUniformBuffer m_passFrame; ///< ID パスの間だけ Renderer のものと差し替える（viewProj がパスの行列）
+
+    GLuint m_prog = 0;          ///< 面（ID は FaceMesh の頂点属性）
+
+    GLuint m_instProg = 0;      ///< INSTANCED（インスタンス属性の ID を書く）
+    GLint  m_instLocPosScale = -1;  ///< 量子化メッシュの位置の復元（Renderer が設定）
+    GLint  m_instLocPosBias = -1;
+
+    PickMode    m_mode = PickMode::GpuIdBuffer;
+    PickTarget  m_target = PickTarget::Faces;
+    mutable TriangleBvh m_bvh;      ///< doPickingCpu が必要になったときに作る
+    mutable bool m_bvhStale = false;
+    double      m_lastPickMicros = 0.0;
+    double      m_lastRegionMillis = 0.0;
+
+    std::vector<uint32_t> m_regionIds;  ///< 範囲読み出しの作業領域
 
     bool   m_pickRequested = false;
     double m_pickX = 0.0, m_pickY = 0.0;
 
+    // --- Async readback ---
+    static constexpr uint32_t kAsyncSlots = 3;
+
+    struct AsyncSlot
+    {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+    };
+
+    AsyncSlot m_async[kAsyncSlots];
+    uint32_t  m_asyncHead = 0, m_asyncTail = 0, m_asyncCount = 0;
+    uint32_t  m_hoveredId = 0;
+
     void createShader();
 
     void ensureFBO(int w, int h);
+    static bool toPixel(int fbW, int fbH, double mouseX, double mouseY, int& px, int& py);
+    bool beginIdPass(const glm::mat4& vp, int fbW, int fbH, int px, int py, int& readX, int& readY);
+    void renderIdPass(const glm::mat4& vp, int w, int h, PickTarget target);
+    void endIdPass();
+
+    void ensureAsync();
+    void issueAsync(const glm::mat4& vp, int fbW, int fbH, int px, int py);
+    void pollAsync();
+    void destroyAsync();
+
     uint32_t doPicking(const glm::mat4& vp, int fbW, int fbH, double mouseX, double mouseY);
+    uint32_t doPickingCpu(const glm::mat4& vp, int fbW, int fbH, double mouseX, double mouseY) const;
 };
 
@@ -0,0 +1,352 @@
+#include "program_registry.h"
+
+#include "chrono"
+#include "cstdio"
+#include "filesystem"
+#include "stdexcept"
+#include "string"
+#include "system_error"
+#include "vector"
+
+#include "frame_uniforms.h"
+#include "gl_state.h"
+#include "shader_utils.h"
+
+namespace
+{
+    constexpr uint32_t kMagic = 0x42505141u;    // "AQPB"
+    constexpr uint32_t kVersion = 1;
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceHash;
+        uint64_t driverHash;
+        uint32_t format;        ///< glGetProgramBinary が返した binaryFormat
+        uint32_t size;
+    };
+
+    struct Entry
+    {
+        std::string key;        ///< path + '\n' + defines
+        GLuint   program = 0;
+        uint32_t refs = 0;
+
+        // acquireAsync() でリンク待ちの間だけ使う（vs が 0 なら完成済み）
+        GLuint   vs = 0, fs = 0;
+        uint64_t sourceHash = 0;
+        bool     cacheable = false;
+    };
+
+    struct Registry
+    {
+        std::vector<Entry> entries;     // 数十個程度なので線形探索で足りる
+        std::string cacheDir = "shader_cache";
+        bool     initialized = false;   ///< 最初の acquire() で GL に問い合わせる
+        bool     binarySupport = false;
+        bool     parallelCompile = false;
+        uint64_t driverHash = 0;
+        program_registry::Stats stats;
+    };
+
+    Registry& registry()
+    {
+        static Registry r;
+        return r;
+    }
+
+    uint64_t fnv1a(std::string_view s, uint64_t h = 14695981039346656037ull)
+    {
+        for (unsigned char c : s)
+        {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        return h;
+    }
+
+    std::string glString(GLenum name)
+    {
+        const GLubyte* s = glGetString(name);
+        return s ? std::string((const char*)s) : std::string();
+    }
+
+    Registry& initialized()
+    {
+        Registry& r = registry();
+        if (r.initialized) return r;
+        r.initialized = true;
+
+        GLint formats = 0;
+        if (glGetProgramBinary && glProgramBinary)
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        r.binarySupport = formats > 0;
+        r.driverHash = fnv1a(glString(GL_VENDOR) + '\n' + glString(GL_RENDERER) + '\n' +
+            glString(GL_VERSION) + '\n' + glString(GL_SHADING_LANGUAGE_VERSION));
+
+        // ドライバのコンパイラスレッドを好きなだけ使わせる
+        if (GLAD_GL_KHR_parallel_shader_compile && glMaxShaderCompilerThreadsKHR)
+        {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+            r.parallelCompile = true;
+        }
+        else if (GLAD_GL_ARB_parallel_shader_compile && glMaxShaderCompilerThreadsARB)
+        {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+            r.parallelCompile = true;
+        }
+        return r;
+    }
+
+    bool diskCacheEnabled()
+    {
+        const Registry& r = initialized();
+        return r.binarySupport && !r.cacheDir.empty();
+    }
+
+    std::filesystem::path cachePath(uint64_t sourceHash)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%016llx_%016llx.bin",
+            (unsigned long long)sourceHash, (unsigned long long)registry().driverHash);
+        return std::filesystem::path(registry().cacheDir) / name;
+    }
+
+    /// @return 作れなければ 0（ファイルが無い・壊れている・ドライバが拒否した）
+    GLuint loadBinary(uint64_t sourceHash)
+    {
+        std::FILE* f = std::fopen(cachePath(sourceHash).string().c_str(), "rb");
+        if (!f) return 0;
+
+        FileHeader h{};
+        std::vector<char> data;
+        bool ok = std::fread(&h, sizeof(h), 1, f) == 1 &&
+            h.magic == kMagic && h.version == kVersion &&
+            h.sourceHash == sourceHash && h.driverHash == registry().driverHash && h.size > 0;
+        if (ok)
+        {
+            data.resize(h.size);
+            ok = std::fread(data.data(), 1, data.size(), f) == data.size();
+        }
+        std::fclose(f);
+        if (!ok) return 0;
+
+        const GLuint program = glCreateProgram();
+        glProgramBinary(program, (GLenum)h.format, data.data(), (GLsizei)h.size);
+
+        GLint linked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked)
+        {
+            glDeleteProgram(program);
+            ++registry().stats.cacheRejected;
+            return 0;
+        }
+        return program;
+    }
+
+    // キャッシュは無くても動くので、書けなければ黙って諦める
+    void saveBinary(GLuint program, uint64_t sourceHash)
+    {
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return;
+
+        std::vector<char> data((size_t)length);
+        GLsizei written = 0;
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &written, &format, data.data());
+        if (written <= 0) return;
+
+        std::error_code ec;
+        std::filesystem::create_directories(registry().cacheDir, ec);
+        if (ec) return;
+
+        // 途中で落ちても壊れたファイルを残さないよう、一時ファイルに書いてから置き換える
+        const std::filesystem::path path = cachePath(sourceHash);
+        std::filesystem::path tmp = path;
+        tmp += ".tmp";
+
+        std::FILE* f = std::fopen(tmp.string().c_str(), "wb");
+        if (!f) return;
+
+        const FileHeader h{ kMagic, kVersion, sourceHash, registry().driverHash, (uint32_t)format, (uint32_t)written };
+        const bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1 &&
+            std::fwrite(data.data(), 1, (size_t)written, f) == (size_t)written;
+        const bool closed = std::fclose(f) == 0;
+
+        if (ok && closed) std::filesystem::rename(tmp, path, ec);
+        else std::filesystem::remove(tmp, ec);
+    }
+
+    // 共通の uniform ブロックを決まった番号につなぐ（GLSL 3.30 には binding の指定が無い）。
+    // ブロックの番号はバイナリに残るとは限らないので、読み戻したものにも毎回行う
+    void bindBlocks(GLuint program)
+    {
+        FrameUniformBuffer::bindBlock(program);
+    }
+
+    Entry* find(const std::string& key)
+    {
+        for (Entry& e : registry().entries)
+            if (e.key == key) return &e;
+        return nullptr;
+    }
+
+    Entry* findProgram(GLuint program)
+    {
+        for (Entry& e : registry().entries)
+            if (e.program == program) return &e;
+        return nullptr;
+    }
+
+    double millisSince(std::chrono::steady_clock::time_point t0)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    /// リンク待ちのエントリを完成させる（まだなら完了まで待つ）
+    void finish(Entry& e)
+    {
+        if (!e.vs) return;
+
+        Registry& r = registry();
+        const auto t0 = std::chrono::steady_clock::now();
+
+        const GLuint vs = e.vs, fs = e.fs;
+        e.vs = e.fs = 0;
+        --r.stats.pending;
+
+        if (!shader_utils::FinishProgram(e.program, vs, fs))
+        {
+            // FinishProgram が削除済み。キャッシュにも残さない
+            const std::string path = e.key.substr(0, e.key.find('\n'));
+            r.entries.erase(r.entries.begin() + (&e - r.entries.data()));
+            throw std::runtime_error("Program link failed: " + path);
+        }
+
+        ++r.stats.compiled;
+        bindBlocks(e.program);
+        if (e.cacheable) saveBinary(e.program, e.sourceHash);
+        r.stats.buildMillis += millisSince(t0);
+    }
+
+    GLuint acquireImpl(const char* path, std::string_view defines, bool async)
+    {
+        Registry& r = initialized();
+
+        std::string extra(defines);
+        if (!extra.empty() && extra.back() != '\n') extra += '\n';
+        std::string key = std::string(path) + '\n' + extra;
+
+        if (Entry* e = find(key))
+        {
+            if (!async) finish(*e);
+            ++e->refs;
+            ++r.stats.shared;
+            return e->program;
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+
+        // ソースは毎回読む（書き換えを検出するためのハッシュに要る）。コンパイルはキャッシュが無いときだけ
+        const std::string src = shader_utils::ReadTextFile(path);
+        Entry e;
+        e.key = std::move(key);
+        e.refs = 1;
+        e.sourceHash = fnv1a(extra, fnv1a(src));
+        e.cacheable = diskCacheEnabled();
+
+        e.program = e.cacheable ? loadBinary(e.sourceHash) : 0;
+        if (e.program)
+        {
+            ++r.stats.cacheHits;
+            bindBlocks(e.program);
+        }
+        else if (async)
+        {
+            e.program = shader_utils::StartProgramFromGLSLSource(src, extra, e.cacheable, e.vs, e.fs);
+            ++r.stats.pending;
+        }
+        else
+        {
+            e.program = shader_utils::BuildProgramFromGLSLSource(src, extra, e.cacheable);
+            ++r.stats.compiled;
+            bindBlocks(e.program);
+            if (e.cacheable) saveBinary(e.program, e.sourceHash);
+        }
+
+        r.stats.buildMillis += millisSince(t0);
+        r.entries.push_back(std::move(e));
+        return r.entries.back().program;
+    }
+}
+
+void program_registry::setCacheDirectory(std::string_view dir)
+{
+    registry().cacheDir = std::string(dir);
+}
+
+GLuint program_registry::acquire(const char* path, std::string_view defines)
+{
+    return acquireImpl(path, defines, false);
+}
+
+GLuint program_registry::acquireAsync(const char* path, std::string_view defines)
+{
+    return acquireImpl(path, defines, true);
+}
+
+bool program_registry::ready(GLuint program, bool wait)
+{
+    Entry* e = findProgram(program);
+    if (!e) return false;
+    if (!e->vs) return true;
+
+    if (!wait)
+    {
+        if (!registry().parallelCompile) return false;
+
+        GLint done = GL_FALSE;
+        glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &done);
+        if (!done) return false;
+    }
+    finish(*e);
+    return true;
+}
+
+bool program_registry::parallelCompile()
+{
+    return initialized().parallelCompile;
+}
+
+void program_registry::release(GLuint program)
+{
+    if (!program) return;
+
+    std::vector<Entry>& entries = registry().entries;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (entries[i].program != program) continue;
+        if (--entries[i].refs == 0)
+        {
+            if (entries[i].vs)
+            {
+                glDeleteShader(entries[i].vs);
+                glDeleteShader(entries[i].fs);
+                --registry().stats.pending;
+            }
+            gl_state::deleteProgram(program);
+            entries.erase(entries.begin() + (ptrdiff_t)i);
+        }
+        return;
+    }
+}
+
+program_registry::Stats program_registry::stats()
+{
+    Stats s = registry().stats;
+    s.programs = (uint32_t)registry().entries.size();
+    return s;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "cstdint"
+#include "string_view"
+
+#include "glad/glad.h"
+
+/**
+ * @brief シェーダプログラムの共有とバイナリキャッシュ
+ *
+ * (ファイル, defines) の組ごとにプログラムを 1 つだけ作り、参照カウントで共有する。
+ * リンク済みのバイナリは glGetProgramBinary でキャッシュディレクトリへ保存し、
+ * 次回の起動では glProgramBinary で読み戻してコンパイルを丸ごと省く。
+ *
+ * - キャッシュのファイル名は「ソース + defines のハッシュ」と「ドライバ文字列のハッシュ」から作る。
+ *   シェーダを書き換えたりドライバが変わったりすると別のファイルになり、自然に作り直しになる
+ * - ドライバが受け付けなかったバイナリ（GL_LINK_STATUS が偽）は捨ててソースから作り直し、上書きする
+ * - バイナリ形式を 1 つも持たないドライバ（GL_NUM_PROGRAM_BINARY_FORMATS が 0）では共有だけ行う
+ * - acquireAsync() はコンパイルを発行するだけで待たない。KHR_parallel_shader_compile があれば
+ *   ドライバのスレッドで進み、ready() が完了を待たずに答える
+ * - uniform ブロック "Frame" を持つプログラムは、出来上がった時点で FrameUniformBuffer::kBinding につなぐ
+ *
+ * コンテキストは 1 つだけを想定（gl_state と同じくメインスレッド専用）。
+ */
+namespace program_registry
+{
+    struct Stats
+    {
+        uint32_t programs = 0;      ///< 生きているプログラム数
+        uint32_t shared = 0;        ///< 既存のプログラムを返した回数
+        uint32_t compiled = 0;      ///< ソースからコンパイルした回数
+        uint32_t cacheHits = 0;     ///< ディスクのバイナリから作った回数
+        uint32_t cacheRejected = 0; ///< ドライバに拒否されたバイナリの数
+        uint32_t pending = 0;       ///< acquireAsync() で作成中のプログラム数
+        double   buildMillis = 0.0; ///< 作成にかかった合計時間（コンパイル / バイナリ読み込み）
+    };
+
+    /// 既定は "shader_cache"（作業ディレクトリ基準）。空にするとディスクキャッシュを使わない
+    void setCacheDirectory(std::string_view dir);
+
+    /**
+     * @brief プログラムを取得する（無ければ作る）。参照カウントを 1 増やす
+     *
+     * defines は shader_utils::BuildProgramFromGLSLFile と同じ形式。
+     * 読み込み・コンパイルの失敗は std::runtime_error。
+     */
+    GLuint acquire(const char* path, std::string_view defines = {});
+
+    /**
+     * @brief acquire() の非同期版。コンパイル・リンクを発行して、完了を待たずに返す
+     *
+     * ディスクキャッシュにあればその場で完成する。使う前に ready() が true になるのを確かめること。
+     * 作成中のものを acquire() すると完了まで待つ。
+     */
+    GLuint acquireAsync(const char* path, std::string_view defines = {});
+
+    /**
+     * @brief 使える状態か
+     *
+     * 完了していればリンク結果を確かめ、バイナリをキャッシュへ書く（失敗は std::runtime_error）。
+     * 並列コンパイルに対応しないドライバでは完了したかを知る手段が無いので、
+     * wait なら完了まで待ち、そうでなければ false を返す。
+     */
+    bool ready(GLuint program, bool wait = false);
+
+    /// KHR / ARB_parallel_shader_compile があるか（ready() が待たずに答えられるか）
+    bool parallelCompile();
+
+    /// 参照カウントを 1 減らし、0 になったら削除する（0 や未登録の名前は無視）
+    void release(GLuint program);
+
+    Stats stats();
+}
@@ -0,0 +1,98 @@
+#include "render/range_allocator.h"
+
+#include "algorithm"
+#include "stdexcept"
+
+RangeAllocator::RangeAllocator(uint32_t capacity)
+{
+    grow(capacity);
+}
+
+uint32_t RangeAllocator::allocate(uint32_t count)
+{
+    if (count == 0) return 0;
+
+    for (size_t i = 0; i < m_free.size(); ++i)
+    {
+        Block& b = m_free[i];
+        if (b.count < count) continue;
+
+        const uint32_t offset = b.offset;
+        b.offset += count;
+        b.count -= count;
+        if (b.count == 0) m_free.erase(m_free.begin() + (ptrdiff_t)i);
+
+        m_freeTotal -= count;
+        return offset;
+    }
+    return kFailed;
+}
+
+void RangeAllocator::release(uint32_t offset, uint32_t count)
+{
+    if (count == 0) return;
+    if (offset + count > m_capacity)
+        throw std::runtime_error("RangeAllocator::release out of range");
+
+    // 挿入位置（offset 昇順）
+    auto it = std::lower_bound(m_free.begin(), m_free.end(), offset,
+        [](const Block& b, uint32_t o) { return b.offset < o; });
+
+    // 前の区間とつながるなら延ばす
+    if (it != m_free.begin())
+    {
+        Block& prev = *(it - 1);
+        if (prev.offset + prev.count == offset)
+        {
+            prev.count += count;
+            if (it != m_free.end() && prev.offset + prev.count == it->offset)
+            {
+                prev.count += it->count;
+                m_free.erase(it);
+            }
+            m_freeTotal += count;
+            return;
+        }
+    }
+
+    // 後ろの区間とつながるなら前へ延ばす
+    if (it != m_free.end() && offset + count == it->offset)
+    {
+        it->offset = offset;
+        it->count += count;
+    }
+    else
+    {
+        m_free.insert(it, Block{ offset, count });
+    }
+    m_freeTotal += count;
+}
+
+void RangeAllocator::grow(uint32_t newCapacity)
+{
+    if (newCapacity <= m_capacity) return;
+
+    const uint32_t added = newCapacity - m_capacity;
+    if (!m_free.empty() && m_free.back().offset + m_free.back().count == m_capacity)
+        m_free.back().count += added;
+    else
+        m_free.push_back(Block{ m_capacity, added });
+
+    m_capacity = newCapacity;
+    m_freeTotal += added;
+}
+
+void RangeAllocator::resetPacked(uint32_t used)
+{
+    m_free.clear();
+    if (used < m_capacity)
+        m_free.push_back(Block{ used, m_capacity - used });
+    m_freeTotal = m_capacity - used;
+}
+
+uint32_t RangeAllocator::largestFree() const
+{
+    uint32_t best = 0;
+    for (const Block& b : m_free) best = std::max(best, b.count);
+    return best;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "cstddef"
+#include "cstdint"
+#include "vector"
+
+/**
+ * @brief 1 次元の範囲アロケータ（要素単位、first-fit）
+ *
+ * 空き区間を offset 順に保持し、解放時は隣接区間と結合する。
+ * GL には依存しない（GeometryPool が VBO / EBO の部分確保に使う）。
+ */
+class RangeAllocator
+{
+public:
+    static constexpr uint32_t kFailed = 0xFFFFFFFFu;
+
+    explicit RangeAllocator(uint32_t capacity = 0);
+
+    /// @return 確保した先頭 offset。入らなければ kFailed
+    uint32_t allocate(uint32_t count);
+    void release(uint32_t offset, uint32_t count);
+
+    /// 末尾に空き区間を足して容量を増やす
+    void grow(uint32_t newCapacity);
+
+    /// 全体を空にし、先頭から used 要素を使用済みにする（詰め直しの後に使う）
+    void resetPacked(uint32_t used);
+
+    uint32_t capacity() const { return m_capacity; }
+    uint32_t freeTotal() const { return m_freeTotal; }
+    uint32_t largestFree() const;
+    size_t   freeBlockCount() const { return m_free.size(); }
+
+private:
+    struct Block
+    {
+        uint32_t offset, count;
+    };
+
+    std::vector<Block> m_free;     ///< offset 昇順、隣接区間は常に結合済み
+    uint32_t m_capacity = 0;
+    uint32_t m_freeTotal = 0;
+};
@@ -0,0 +1,136 @@
+#include "render_queue.h"
+
+#include "stdexcept"
+
+#include "glm/gtc/type_ptr.hpp"
+
+#include "render/gl_state.h"
+
+uint16_t RenderQueue::addProgram(const ProgramInfo& info)
+{
+    if (m_programs.size() >= (1u << sort_key::kIdBits))
+        throw std::runtime_error("RenderQueue::addProgram too many programs");
+
+    ProgramState state;
+    state.info = info;
+    m_programs.push_back(state);
+    return (uint16_t)(m_programs.size() - 1);
+}
+
+void RenderQueue::reset()
+{
+    m_packets.clear();
+    m_entries.clear();
+}
+
+void RenderQueue::submit(const Packet& packet)
+{
+    if (packet.program >= m_programs.size())
+        throw std::runtime_error("RenderQueue::submit unknown program");
+    if (packet.instanceCount <= 0) return;
+
+    const GLuint vao = packet.pool ? packet.pool->vao() : packet.vao;
+    const uint64_t key = packet.translucent
+        ? sort_key::translucent(packet.pass, packet.program, vao, packet.depth)
+        : sort_key::opaque(packet.pass, packet.program, vao, packet.depth);
+
+    m_entries.push_back({ key, (uint32_t)m_packets.size() });
+    m_packets.push_back(packet);
+}
+
+void RenderQueue::execute()
+{
+    m_stats = {};
+    m_stats.packets = (uint32_t)m_packets.size();
+    if (m_packets.empty()) return;
+
+    sort_key::radixSort(m_entries, m_scratch);
+
+    for (ProgramState& s : m_programs)
+        s.known = false;
+
+    uint32_t program = ~0u;
+    GLuint vao = ~0u;
+    GLuint firstInstance = ~0u;
+    for (const sort_key::Entry& e : m_entries)
+    {
+        const Packet& p = m_packets[e.index];
+        ProgramState& state = m_programs[p.program];
+
+        if (p.program != program)
+        {
+            program = p.program;
+            ++m_stats.programChanges;
+            gl_state::useProgram(state.info.program);
+        }
+
+        gl_state::setEnabled(GL_BLEND, p.translucent);
+        if (p.translucent) gl_state::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gl_state::depthMask(!p.translucent);
+
+        gl_state::setEnabled(GL_POLYGON_OFFSET_FILL, p.offset != Offset::None);
+        if (p.offset == Offset::Behind) gl_state::polygonOffset(1.0f, 1.0f);
+        else if (p.offset == Offset::Front) gl_state::polygonOffset(-1.0f, -1.0f);
+
+        const GLuint packetVao = p.pool ? p.pool->vao() : p.vao;
+        if (packetVao != vao)
+        {
+            vao = packetVao;
+            firstInstance = ~0u;
+            ++m_stats.vaoChanges;
+            gl_state::bindVertexArray(vao);
+        }
+
+        // インスタンス属性の offset は VAO の状態なので、VAO か範囲が変わったときだけ付け替える
+        if (m_instances && p.firstInstance != kNoInstances && p.firstInstance != firstInstance)
+        {
+            firstInstance = p.firstInstance;
+            m_instances->setFirstInstance(firstInstance);
+        }
+
+        applyUniforms(state, p);
+
+        if (p.pool)
+            p.pool->draw(p.handle, p.mode, p.instanceCount);
+        else if (p.instanceCount == 1)
+            glDrawArrays(p.mode, p.first, p.count);
+        else
+            glDrawArraysInstanced(p.mode, p.first, p.count, p.instanceCount);
+    }
+
+    gl_state::disable(GL_POLYGON_OFFSET_FILL);
+    gl_state::depthMask(true);
+    reset();
+}
+
+void RenderQueue::applyUniforms(ProgramState& state, const Packet& p)
+{
+    const ProgramInfo& info = state.info;
+    const bool all = !state.known;
+    state.known = true;
+
+    if (info.locPosScale >= 0 && (all || state.posScale != p.posScale))
+    {
+        state.posScale = p.posScale;
+        glUniform3fv(info.locPosScale, 1, glm::value_ptr(p.posScale));
+        ++m_stats.uniformUploads;
+    }
+    if (info.locPosBias >= 0 && (all || state.posBias != p.posBias))
+    {
+        state.posBias = p.posBias;
+        glUniform3fv(info.locPosBias, 1, glm::value_ptr(p.posBias));
+        ++m_stats.uniformUploads;
+    }
+    if (info.locShade >= 0 && (all || state.shade != p.shade))
+    {
+        state.shade = p.shade;
+        glUniform1f(info.locShade, p.shade);
+        ++m_stats.uniformUploads;
+    }
+    if (info.locColor >= 0 && (all || state.color != p.color))
+    {
+        state.color = p.color;
+        glUniform4fv(info.locColor, 1, glm::value_ptr(p.color));
+        ++m_stats.uniformUploads;
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "cstdint"
+#include "vector"
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "render/geometry_pool.h"
+#include "render/instance_buffer.h"
+#include "render/sort_key.h"
+
+/**
+ * @brief ソートキー付きの描画キュー
+ *
+ * 各パスは submit() でパケット（1 ドロー分のステートと範囲）を積むだけで、GL は呼ばない。
+ * execute() でキーを基数ソートしてから順に実行する。
+ * キーは sort_key を参照（pass → 不透明 / 半透明 → プログラム → VAO → 深度）。
+ *
+ * - パケットは積んだ順の配列に置いたまま、並べ替えるのは 16 バイトのキーだけ
+ * - プログラム・VAO・enable は gl_state 経由（同じなら呼ばれない）
+ * - uniform もプログラムごとに前回値を覚えて、変わったものだけ送る
+ * - カメラの行列はフレームの uniform バッファ（FrameUniformBuffer）から読むので、ここでは送らない
+ * - 配列はフレームをまたいで使い回す（10 万ドローでも毎フレームの確保は無い）
+ */
+class RenderQueue
+{
+public:
+    enum Pass : uint8_t
+    {
+        kPassMain = 0,
+        kPassOverlay,   ///< メインの後（ギズモなど）
+    };
+
+    enum class Offset : uint8_t
+    {
+        None,
+        Behind,     ///< 奥へ押す（ワイヤより後ろに面を置く）
+        Front,      ///< 手前へ引く（面の上に重ねるハイライト）
+    };
+
+    /// addProgram() に渡す uniform の位置（無いものは -1）
+    struct ProgramInfo
+    {
+        GLuint program = 0;
+        GLint  locPosScale = -1;
+        GLint  locPosBias = -1;
+        GLint  locShade = -1;
+        GLint  locColor = -1;
+    };
+
+    /// Packet::firstInstance に入れると、インスタンス属性を付け替えない（属性を読まないプログラム用）
+    static constexpr GLuint kNoInstances = ~0u;
+
+    struct Packet
+    {
+        uint16_t program = 0;       ///< addProgram() の番号
+        Offset   offset = Offset::None;
+        bool     translucent = false;   ///< アルファブレンド・奥から手前へ・深度は書かない
+        uint8_t  pass = kPassMain;
+        float    depth = 0.0f;      ///< [0, 1]、0 が手前
+
+        // pool があればその区画を描く。無ければ vao の [first, first + count) を glDrawArrays
+        const GeometryPool* pool = nullptr;
+        GeometryPool::Handle handle = GeometryPool::kInvalidHandle;
+        GLuint  vao = 0;
+        GLint   first = 0;
+        GLsizei count = 0;
+
+        GLenum  mode = GL_TRIANGLES;
+        GLsizei instanceCount = 1;
+        GLuint  firstInstance = 0;  ///< インスタンス VBO 内の先頭（instances() 設定時のみ使う）
+
+        glm::vec3 posScale = glm::vec3(1.0f);
+        glm::vec3 posBias = glm::vec3(0.0f);
+        float     shade = 0.0f;
+        glm::vec4 color = glm::vec4(1.0f);
+    };
+
+    struct Stats
+    {
+        uint32_t packets = 0;
+        uint32_t programChanges = 0;
+        uint32_t vaoChanges = 0;
+        uint32_t uniformUploads = 0;
+    };
+
+    uint16_t addProgram(const ProgramInfo& info);
+    void clearPrograms() { m_programs.clear(); }
+
+    /// インスタンス属性の先頭をパケットごとに firstInstance へ合わせる（nullptr なら触らない）
+    void setInstances(const InstanceBuffer* instances) { m_instances = instances; }
+
+    void reset();
+    void submit(const Packet& packet);
+
+    /// ソートして実行し、空にする
+    void execute();
+
+    size_t size() const { return m_packets.size(); }
+    Stats lastStats() const { return m_stats; }
+
+private:
+    struct ProgramState
+    {
+        ProgramInfo info;
+
+        // 前回送った値（execute() の先頭で不明に戻す）
+        bool      known = false;
+        glm::vec3 posScale{}, posBias{};
+        float     shade = 0.0f;
+        glm::vec4 color{};
+    };
+
+    std::vector<ProgramState>    m_programs;
+    std::vector<Packet>          m_packets;
+    std::vector<sort_key::Entry> m_entries;
+    std::vector<sort_key::Entry> m_scratch;
+    const InstanceBuffer* m_instances = nullptr;
+    Stats m_stats;
+
+    void applyUniforms(ProgramState& state, const Packet& p);
+};
@@ -1,6 +1,8 @@
 #include "renderer.h"
 
+#include "algorithm"
 #include "stdexcept"
+#include "utility"
 #include "vector"
 
 #include "glad/glad.h"
@@ -8,7 +10,12 @@
 #include "glm/gtc/type_ptr.hpp"
 
 #include "render/geometry_gen.h"
+#include "render/gl_state.h"
+#include "render/mesh_builder.h"
+#include "render/program_registry.h"
 #include "render/shader_utils.h"
+#include "render/vertex_layout.h"
+#include "render/vertex_pack.h"
 
 Renderer::Renderer() = default;
 
@@ -17,110 +24,516 @@ Renderer::~Renderer()
     destroy();
 }
 
-void Renderer::init()
+void Renderer::init(const EditMesh& mesh)
 {
-    m_lineProg.create();
-    m_gridMesh.upload(geometry_gen::generateGrid());
-    m_cubeWireMesh.upload(geometry_gen::generateCubeWire());
-
-    auto verts = geometry_gen::createCubeSharedVerts(0.25f);
-    auto idx = geometry_gen::createCubeSharedIndices();
-    m_meshProg.create();
-    m_cubeMesh.upload(verts, idx);
+    // 圧縮形式は読み込み時に選んだときだけ使うので小さく始める（足りなければ伸びる）
+    pool(VertexFormat::Full).init(VertexFormat::Full);
+    pool(VertexFormat::Packed).init(VertexFormat::Packed, 1u << 12, 1u << 14);
+    pool(VertexFormat::Quantized).init(VertexFormat::Quantized, 1u << 12, 1u << 14);
+    m_stream.init(1u << 20);
+    m_frame.init();
+
+    // ハイライト用 VAO。位置はストリームの先頭から読み、描画時は first で範囲を選ぶ
+    glGenVertexArrays(1, &m_highlightVao);
+    gl_state::bindVertexArray(m_highlightVao);
+    gl_state::bindBuffer(GL_ARRAY_BUFFER, m_stream.buffer());
+    vertex_layout::apply(vertex_layout::of<glm::vec3>());
+
+    // グリッドは頂点バッファを持たないが、コアプロファイルでは何かの VAO が要る
+    glGenVertexArrays(1, &m_gridVao);
+    m_gridProg = program_registry::acquire("assets/shaders/grid.glsl");
+    m_gridLocDistance = shader_utils::GetUniformOrThrow(m_gridProg, "uCameraDistance");
+
+    // 専用バリアントは最初に描くときに作り始める。それまでの代用（汎用版）だけは今作っておく
+    static constexpr const char* kLineFeatures[] = { "INSTANCED", "PACKED_VERTEX", "QUANTIZED_POSITION", "DYNAMIC" };
+    static constexpr const char* kLineUniforms[] = { "uPosScale", "uPosBias", "uShade" };
+    m_lineVariants.create("assets/shaders/line.glsl", kLineFeatures, kLineUniforms);
+    m_lineVariants.request(kLineInstanced | kLineDynamic, kLineInstanced | kLineDynamic);
+
+    // 部品は小さな立方体（色はインスタンス色で付ける）
+    const EditMesh part = geometry_gen::createCube(0.5f);
+    std::vector<Vertex> partVerts;
+    std::vector<uint32_t> partIdx;
+    mesh_builder::buildTriangles(part, glm::vec4(1.0f), partVerts, partIdx);
+    m_meshes[kPartMesh].solid.emplace<Mesh<Vertex>>().upload(pool(VertexFormat::Full),
+        std::span<const Vertex>(partVerts), partIdx);
+    const std::vector<Vertex> partLines = mesh_builder::buildEdgeLines(part, glm::vec4(0.1f, 0.1f, 0.1f, 1.0f));
+    m_meshes[kPartMesh].lines.upload(pool(VertexFormat::Full), std::span<const Vertex>(partLines), {}, GL_LINES);
 
     createSolidShader();
-    generateCubeSolidMesh();
+
+    m_queue.setInstances(&m_instances);
+    m_queueLinePrograms.fill(kNoQueueProgram);
+    m_queueSolidProg = m_queue.addProgram({ m_solidProg, -1, -1, -1, m_solidLocColor });
+    m_queueGridProg = m_queue.addProgram({ m_gridProg, -1, -1, -1, -1 });
+
+    setMesh(mesh);
 }
 
 void Renderer::destroy()
 {
-    m_gridMesh.destroy();
-    m_cubeWireMesh.destroy();
-    m_lineProg.destroy();
-    m_meshProg.destroy();
-    m_cubeMesh.destroy();
+    for (RenderMesh& m : m_meshes)
+    {
+        m.lines.destroy();
+        m.solid.emplace<Mesh<Vertex>>();
+        m.firstInstance = 0;
+        m.instanceCount = 0;
+        m.shaded = false;
+    }
+    m_queue.reset();
+    m_queue.clearPrograms();
+    m_queueLinePrograms.fill(kNoQueueProgram);
+    m_instances.destroy();
+    for (GeometryPool& p : m_pools)
+        p.destroy();
+    if (m_highlightVao) { gl_state::deleteVertexArray(m_highlightVao); m_highlightVao = 0; }
+    if (m_gridVao) { gl_state::deleteVertexArray(m_gridVao); m_gridVao = 0; }
+    m_stream.destroy();
+    m_frame.destroy();
+    m_faceTris = {};
+    m_faceDirty.clear();
+    m_lineSlots = {};
+    m_faceSlots = {};
+    m_solidFromEditMesh = false;
+    m_sceneRevision = ~0ull;
+    m_instancesStale = true;
+    m_lineVariants.destroy();
+    m_faceMesh.destroy();
+
+    program_registry::release(m_solidProg);
+    m_solidProg = 0;
+    m_solidLocColor = -1;
 
-    if (m_cubeSolidVBO) { glDeleteBuffers(1, &m_cubeSolidVBO); m_cubeSolidVBO = 0; }
-    if (m_cubeSolidVAO) { glDeleteVertexArrays(1, &m_cubeSolidVAO); m_cubeSolidVAO = 0; }
+    program_registry::release(m_gridProg);
+    m_gridProg = 0;
+    m_gridLocDistance = -1;
+    m_gridUploaded = -1.0f;
+}
 
-    if (m_solidProg) { glDeleteProgram(m_solidProg); m_solidProg = 0; }
-    m_solidLocMVP = -1;
-    m_solidLocColor = -1;
+Renderer::EditGeometry Renderer::buildEditGeometry(const EditMesh& mesh)
+{
+    // 頂点移動を部分更新できるよう、出力頂点ごとの元の頂点番号から逆引き表も作っておく
+    EditGeometry g;
+    std::vector<uint32_t> source;
+    g.lines = mesh_builder::buildEdgeLines(mesh, glm::vec4(0.95f, 0.85f, 0.35f, 1.0f), &source);
+    g.lineSlots = mesh_builder::invertSource(source, mesh.vertexCount());
+    g.faceTris = mesh_builder::buildFaceTriangles(mesh, &source);
+    g.faceSlots = mesh_builder::invertSource(source, mesh.vertexCount());
+    return g;
 }
 
-void Renderer::draw(const glm::mat4& vp, int w, int h, uint32_t selectedFace)
+void Renderer::uploadEditGeometry(EditGeometry&& geometry)
 {
-    glViewport(0, 0, w, h);
-    glClearColor(0.1f, 0.1f, 0.12f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    RenderMesh& edit = m_meshes[kEditMesh];
+    edit.lines.uploadEditable(pool(VertexFormat::Full), std::span<const Vertex>(geometry.lines), {}, GL_LINES);
+    m_lineSlots = std::move(geometry.lineSlots);
+
+    m_faceTris = std::move(geometry.faceTris);
+    m_faceSlots = std::move(geometry.faceSlots);
+    m_faceMesh.upload(m_faceTris);
+    m_faceDirty.clear();
+    m_instancesStale = true;
+}
 
-    // まず線（グリッド・ワイヤ）
-    glUseProgram(m_lineProg.m_prog);
-    glUniformMatrix4fv(m_lineProg.m_locMVP, 1, GL_FALSE, glm::value_ptr(vp));
+void Renderer::setMesh(const EditMesh& mesh)
+{
+    // ワイヤ・面・ピッキング用の GPU バッファはすべて同じ EditMesh から作る
+    EditGeometry geometry = buildEditGeometry(mesh);
+    std::vector<Vertex> verts;
+    std::vector<uint32_t> idx;
+    mesh_builder::buildTriangles(mesh, glm::vec4(0.35f, 0.35f, 0.35f, 1.0f), verts, idx);
+
+    RenderMesh& edit = m_meshes[kEditMesh];
+    edit.solid.emplace<Mesh<Vertex>>().uploadEditable(pool(VertexFormat::Full), std::span<const Vertex>(verts), idx);
+    edit.shaded = false;
+    m_solidFromEditMesh = true;
+    uploadEditGeometry(std::move(geometry));
+}
 
-    m_cubeWireMesh.draw();
-    m_gridMesh.draw();
-    m_cubeMesh.draw();
+void Renderer::setMesh(const EditMesh& mesh, std::span<const Vertex> verts, std::span<const uint32_t> indices,
+    VertexFormat format, std::span<const glm::vec3> normals, std::span<const glm::vec2> texcoords)
+{
+    // setSolidMesh は変換を済ませてから面を差し替えるので、投げるならワイヤ・面のどちらにも触る前
+    EditGeometry geometry = buildEditGeometry(mesh);
+    setSolidMesh(verts, indices, format, normals, texcoords);
+    uploadEditGeometry(std::move(geometry));
+}
 
-    glUseProgram(0);
+void Renderer::setSolidMesh(std::span<const Vertex> verts, std::span<const uint32_t> indices,
+    VertexFormat format, std::span<const glm::vec3> normals, std::span<const glm::vec2> texcoords)
+{
+    // 読み込み済みの頂点列（v/vt/vn 分割・頂点色あり）をそのまま使う
+    // Full ならキャッシュのマップ領域もコピーせずに渡せる（CPU 側に写しは残さない）
+    RenderMesh& edit = m_meshes[kEditMesh];
+    switch (format)
+    {
+    case VertexFormat::Packed:
+    {
+        std::vector<PackedVertex> packed;
+        vertex_pack::pack(verts, normals, texcoords, packed);
+        edit.solid.emplace<Mesh<PackedVertex>>().upload(pool(format), std::span<const PackedVertex>(packed), indices);
+        break;
+    }
+    case VertexFormat::Quantized:
+    {
+        std::vector<QuantizedVertex> packed;
+        const vertex_pack::Dequantize dq = vertex_pack::quantize(verts, normals, texcoords, packed);
+        Mesh<QuantizedVertex>& solid = edit.solid.emplace<Mesh<QuantizedVertex>>();
+        solid.upload(pool(format), std::span<const QuantizedVertex>(packed), indices);
+        solid.m_dequant = dq;
+        break;
+    }
+    default:
+        edit.solid.emplace<Mesh<Vertex>>().upload(pool(VertexFormat::Full), verts, indices);
+        break;
+    }
+    edit.shaded = (format != VertexFormat::Full) && !normals.empty();
+    m_solidFromEditMesh = false;
+    m_instancesStale = true;
+}
 
-    // 次に選択面ハイライト
-    drawSelectedFaceFill(vp, selectedFace);
+void Renderer::updatePositions(const EditMesh& mesh, std::span<const uint32_t> verts)
+{
+    RenderMesh& edit = m_meshes[kEditMesh];
+
+    if (!m_solidFromEditMesh)
+    {
+        // 分割済みの頂点列は EditMesh の頂点と対応しないので、編集に入った時点で作り直す
+        std::vector<Vertex> solidVerts;
+        std::vector<uint32_t> idx;
+        mesh_builder::buildTriangles(mesh, glm::vec4(0.35f, 0.35f, 0.35f, 1.0f), solidVerts, idx);
+        edit.solid.emplace<Mesh<Vertex>>().uploadEditable(pool(VertexFormat::Full),
+            std::span<const Vertex>(solidVerts), idx);
+        edit.shaded = false;
+        m_solidFromEditMesh = true;
+    }
+    Mesh<Vertex>& solid = std::get<Mesh<Vertex>>(edit.solid);
+
+    for (uint32_t v : verts)
+    {
+        if (v >= mesh.vertexCount()) continue;
+        const glm::vec3& p = mesh.position(v);
+
+        solid.setPosition(v, p);
+
+        if (v + 1 < m_lineSlots.first.size())
+        {
+            for (uint32_t i = m_lineSlots.first[v]; i < m_lineSlots.first[v + 1]; ++i)
+                edit.lines.setPosition(m_lineSlots.slots[i], p);
+        }
+        if (v + 1 < m_faceSlots.first.size())
+        {
+            for (uint32_t i = m_faceSlots.first[v]; i < m_faceSlots.first[v + 1]; ++i)
+            {
+                const uint32_t slot = m_faceSlots.slots[i];
+                m_faceTris.positions[slot] = p;
+                m_faceDirty.add(slot, 1);
+            }
+        }
+    }
 }
 
-void Renderer::createSolidShader()
+void Renderer::flushEdits()
 {
-    m_solidProg = shader_utils::BuildProgramFromGLSLFile("assets/shaders/solid.glsl");
-    m_solidLocMVP = shader_utils::GetUniformOrThrow(m_solidProg, "uMVP");
-    m_solidLocColor = shader_utils::GetUniformOrThrow(m_solidProg, "uColor");
+    // 溜まった変更をフレームに 1 回だけ送る（量は変更した頂点数に比例）
+    RenderMesh& edit = m_meshes[kEditMesh];
+    size_t bytes = edit.lines.flush();
+    if (Mesh<Vertex>* solid = std::get_if<Mesh<Vertex>>(&edit.solid))
+        bytes += solid->flush();
+    bytes += m_faceMesh.update(m_faceTris.positions, m_faceDirty);
+    m_lastUploadBytes = bytes;
 }
 
-void Renderer::generateCubeSolidMesh()
+void Renderer::draw(const Scene& scene, const FaceSelection& selection, uint32_t hoveredFace,
+    std::span<const uint8_t> visible)
 {
-    auto pos = geometry_gen::generateCubeSolidPositions(0.5f);
+    const FrameUniforms& frame = m_frame.data();
+    flushEdits();
+    m_lineVariants.update();    // 作成中の専用バリアントが出来ていれば次の lineProgram() から使われる
+
+    // 今フレームでストリームに書く量を先に見積もってから区画を進める
+    const bool culled = !visible.empty();
+    const bool rebuild = instancesDirty(scene, visible);
+    const uint32_t instanceTotal = rebuild ? countInstances(scene, visible) : 0;
+
+    const bool showHover = hoveredFace != 0 && !selection.contains(hoveredFace);
+    const size_t hoverVerts = showHover ? highlightVertexCount(std::span<const uint32_t>(&hoveredFace, 1)) : 0;
+    const size_t selectVerts = highlightVertexCount(selection.ids());
+
+    // 各 map() のアラインメントで空く分（ストライド 1 個ぶん）も足しておく
+    size_t streamBytes = (hoverVerts + selectVerts + 2) * sizeof(glm::vec3);
+    if (rebuild && culled) streamBytes += (instanceTotal + 1) * sizeof(InstanceData);
+    m_stream.beginFrame(streamBytes);
+
+    if (rebuild) fillInstances(scene, visible, instanceTotal);
+
+    // ピッキングなどが変えたステートはここで必要な分だけ戻す（同じ値なら GL は呼ばれない）
+    gl_state::viewport((GLint)frame.viewport.x, (GLint)frame.viewport.y,
+        (GLsizei)frame.viewport.z, (GLsizei)frame.viewport.w);
+    m_frame.bind();
+    gl_state::enable(GL_DEPTH_TEST);
+    gl_state::depthMask(true);
+    gl_state::enable(GL_BLEND);
+    gl_state::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glClearColor(0.1f, 0.1f, 0.12f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glGenVertexArrays(1, &m_cubeSolidVAO);
-    glGenBuffers(1, &m_cubeSolidVBO);
+    // 線・面・ハイライトをキューに積み、ソートしてまとめて描く
+    // モデル行列はインスタンス属性、VP はフレームの uniform バッファから読む
+    submitMeshes();
+    submitGrid();
+    if (showHover)
+        submitFaceFill(frame.viewProj, std::span<const uint32_t>(&hoveredFace, 1), glm::vec4(0.6f, 0.8f, 1.0f, 0.15f));
+    submitFaceFill(frame.viewProj, selection.ids(), glm::vec4(1.0f, 0.8f, 0.2f, 0.25f));
+    m_queue.execute();
 
-    glBindVertexArray(m_cubeSolidVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_cubeSolidVBO);
-    glBufferData(GL_ARRAY_BUFFER, pos.size() * sizeof(glm::vec3), pos.data(), GL_STATIC_DRAW);
+    m_stream.endFrame();
+}
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+void Renderer::drawInstancedSolids(GLint locPosScale, GLint locPosBias) const
+{
+    drawSolids({ locPosScale, locPosBias, -1 });
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+void Renderer::submitMeshes()
+{
+    for (const RenderMesh& m : m_meshes)
+    {
+        if (m.instanceCount == 0) continue;
+
+        RenderQueue::Packet packet;
+        packet.program = lineProgram(kLineInstanced);
+        packet.instanceCount = m.instanceCount;
+        packet.firstInstance = m.firstInstance;
+
+        if (!m.lines.empty())
+        {
+            packet.pool = m.lines.m_pool;
+            packet.handle = m.lines.m_handle;
+            packet.mode = m.lines.m_primitive;
+            m_queue.submit(packet);
+        }
+
+        // 面はワイヤより奥へ押し出す（Z-fighting対策）
+        // 量子化の復元・陰影は専用バリアントで行う（代用の汎用版ではパケットごとの uniform）
+        const MeshBase& solid = m.solidBase();
+        if (solid.m_indexCount > 0)
+        {
+            ShaderVariants::Mask mask = kLineInstanced;
+            if (m.shaded) mask |= kLinePacked;
+            if (solid.format() == VertexFormat::Quantized) mask |= kLineQuantized;
+            packet.program = lineProgram(mask);
+            packet.pool = solid.m_pool;
+            packet.handle = solid.m_handle;
+            packet.mode = solid.m_primitive;
+            packet.offset = RenderQueue::Offset::Behind;
+            packet.posScale = solid.m_dequant.scale;
+            packet.posBias = solid.m_dequant.bias;
+            packet.shade = m.shaded ? 1.0f : 0.0f;
+            m_queue.submit(packet);
+        }
+    }
 }
 
-void Renderer::drawSelectedFaceFill(const glm::mat4& vp, uint32_t selectedFace)
+void Renderer::drawSolids(const SolidUniforms& uniforms) const
 {
-    if (selectedFace == 0) return;
+    // 形式（= プールの VAO）ごとにまとめて描く
+    for (const GeometryPool& p : m_pools)
+    {
+        bool bound = false;
+        for (const RenderMesh& m : m_meshes)
+        {
+            const MeshBase& solid = m.solidBase();
+            if (solid.m_indexCount == 0 || m.instanceCount == 0) continue;
+            if (solid.m_pool != &p) continue;
+
+            if (!bound) { p.bind(); bound = true; }
+            glUniform3fv(uniforms.posScale, 1, glm::value_ptr(solid.m_dequant.scale));
+            glUniform3fv(uniforms.posBias, 1, glm::value_ptr(solid.m_dequant.bias));
+            glUniform1f(uniforms.shade, m.shaded ? 1.0f : 0.0f);
+
+            m_instances.setFirstInstance(m.firstInstance);
+            solid.drawInstanced(m.instanceCount);
+        }
+    }
+
+    // 線の描画に戻ったときのために恒等へ戻す
+    glUniform3f(uniforms.posScale, 1.0f, 1.0f, 1.0f);
+    glUniform3f(uniforms.posBias, 0.0f, 0.0f, 0.0f);
+    glUniform1f(uniforms.shade, 0.0f);
+}
 
-    const uint32_t face = selectedFace; // 1..6
-    const GLint first = (GLint)((face - 1) * 6);
-    const GLsizei count = 6;
+bool Renderer::instancesDirty(const Scene& scene, std::span<const uint8_t> visible) const
+{
+    // カリング後のリストはカメラ次第なので毎フレーム作り直す
+    return !visible.empty() || scene.revision() != m_sceneRevision || m_instancesStale;
+}
 
-    // 深度は有効のまま
-    glEnable(GL_DEPTH_TEST);
+uint32_t Renderer::countInstances(const Scene& scene, std::span<const uint8_t> visible)
+{
+    const bool culled = !visible.empty();
+    const std::span<const uint32_t> meshes = scene.meshes();
+
+    std::array<uint32_t, kMeshCount> counts{};
+    for (uint32_t n = 0; n < scene.nodeCount(); ++n)
+    {
+        if (meshes[n] >= kMeshCount) continue;
+        if (culled && (n >= visible.size() || !visible[n])) continue;
+        ++counts[meshes[n]];
+    }
+
+    // メッシュ順に連結した中での各メッシュの範囲
+    uint32_t total = 0;
+    for (uint32_t id = 0; id < kMeshCount; ++id)
+    {
+        m_meshes[id].firstInstance = total;
+        m_meshes[id].instanceCount = (GLsizei)counts[id];
+        total += counts[id];
+    }
+    return total;
+}
 
-    // Z-fighting対策
-    glEnable(GL_POLYGON_OFFSET_FILL);
-    glPolygonOffset(-1.0f, -1.0f);
+void Renderer::fillInstances(const Scene& scene, std::span<const uint8_t> visible, uint32_t total)
+{
+    const bool culled = !visible.empty();
+
+    // カリング時は毎フレーム変わるので、ストリームの区画へ中間バッファ無しで直接書く
+    InstanceData* dst;
+    if (culled)
+    {
+        dst = m_instances.map(m_stream, total);
+    }
+    else
+    {
+        m_instanceUpload.resize(total);
+        dst = m_instanceUpload.data();
+    }
+
+    const std::span<const uint32_t> meshes = scene.meshes();
+    const std::span<const glm::mat4> worlds = scene.worlds();
+    const std::span<const glm::vec4> colors = scene.colors();
+
+    std::array<uint32_t, kMeshCount> cursor{};
+    for (uint32_t id = 0; id < kMeshCount; ++id)
+        cursor[id] = m_meshes[id].firstInstance;
+
+    // ノード ID = node + 1（0 はピッキングのクリア値）
+    for (uint32_t n = 0; n < scene.nodeCount(); ++n)
+    {
+        if (meshes[n] >= kMeshCount) continue;
+        if (culled && (n >= visible.size() || !visible[n])) continue;
+        dst[cursor[meshes[n]]++] = { worlds[n], colors[n], n + 1, {} };
+    }
+
+    if (culled)
+        m_stream.unmap();
+    else
+        m_instances.upload(m_instanceUpload);
+
+    // 属性の参照先（静的 VBO / ストリーム）が変わりうるので毎回登録し直す
+    // 描画時は setFirstInstance でメッシュごとの範囲に切り替える
+    for (const GeometryPool& p : m_pools)
+        m_instances.attach(p.vao());
+
+    // 選択ハイライトは編集メッシュの全インスタンスに重ねる
+    m_instances.attach(m_highlightVao, m_meshes[kEditMesh].firstInstance);
+
+    m_sceneRevision = culled ? ~0ull : scene.revision();
+    m_instancesStale = false;
+}
 
-    // 透明
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+size_t Renderer::highlightVertexCount(std::span<const uint32_t> faceIds) const
+{
+    size_t count = 0;
+    for (uint32_t id : faceIds)
+    {
+        if (id == 0 || id > m_faceMesh.faceCount()) continue;
+        count += (size_t)m_faceMesh.faceVertexCount(id - 1);
+    }
+    return count;
+}
 
-    glUseProgram(m_solidProg);
-    glUniformMatrix4fv(m_solidLocMVP, 1, GL_FALSE, glm::value_ptr(vp));
-    glUniform4f(m_solidLocColor, 1.0f, 0.8f, 0.2f, 0.25f);
+uint16_t Renderer::lineProgram(ShaderVariants::Mask mask)
+{
+    const ShaderVariants::Mask use = m_lineVariants.request(mask, (mask & kLineInstanced) | kLineDynamic);
+
+    // バリアントごとにキューのプログラム（= uniform の前回値）を分ける
+    uint16_t& id = m_queueLinePrograms[use];
+    if (id == kNoQueueProgram)
+    {
+        const ShaderVariants::Variant& v = m_lineVariants.variant(use);
+        id = m_queue.addProgram({ v.program, v.locations[0], v.locations[1], v.locations[2], -1 });
+    }
+    return id;
+}
 
-    glBindVertexArray(m_cubeSolidVAO);
-    glDrawArrays(GL_TRIANGLES, first, count);
-    glBindVertexArray(0);
+void Renderer::createSolidShader()
+{
+    m_solidProg = program_registry::acquire("assets/shaders/solid.glsl", "#define INSTANCED 1");
+    m_solidLocColor = shader_utils::GetUniformOrThrow(m_solidProg, "uColor");
+}
 
-    glUseProgram(0);
+void Renderer::submitGrid()
+{
+    if (!m_gridVisible) return;
+
+    // 距離はパケットの uniform に無いので、変わったときだけここで送る
+    if (m_gridUploaded != m_gridDistance)
+    {
+        gl_state::useProgram(m_gridProg);
+        glUniform1f(m_gridLocDistance, m_gridDistance);
+        m_gridUploaded = m_gridDistance;
+    }
+
+    // 画面全体を覆う半透明。一番奥として扱い、ハイライトより先に描く
+    RenderQueue::Packet packet;
+    packet.program = m_queueGridProg;
+    packet.translucent = true;
+    packet.depth = 1.0f;
+    packet.vao = m_gridVao;
+    packet.count = 3;
+    packet.firstInstance = RenderQueue::kNoInstances;
+    m_queue.submit(packet);
+}
 
-    glDisable(GL_POLYGON_OFFSET_FILL);
-}
\ No newline at end of file
+void Renderer::submitFaceFill(const glm::mat4& vp, std::span<const uint32_t> faceIds, const glm::vec4& color)
+{
+    if (faceIds.empty()) return;
+
+    // 選択面の三角形をストリームへ詰めて 1 回で描く（面 ID は face + 1、0 は未選択）
+    // 半透明どうしの順序用に、三角形の重心の深度も求めておく（インスタンスの変換は無視）
+    const size_t vertexCount = highlightVertexCount(faceIds);
+    size_t offset = 0;
+    glm::vec3* dst = (glm::vec3*)m_stream.map(vertexCount * sizeof(glm::vec3), sizeof(glm::vec3), offset);
+    glm::vec3 center(0.0f);
+    for (uint32_t id : faceIds)
+    {
+        if (id == 0 || id > m_faceMesh.faceCount()) continue;
+        const uint32_t first = m_faceTris.faceFirst[id - 1];
+        const uint32_t last = m_faceTris.faceFirst[id];
+        for (uint32_t i = first; i < last; ++i)
+            center += m_faceTris.positions[i];
+        std::copy(m_faceTris.positions.begin() + first, m_faceTris.positions.begin() + last, dst);
+        dst += last - first;
+    }
+    m_stream.unmap();
+
+    const GLsizei instanceCount = m_meshes[kEditMesh].instanceCount;
+    if (vertexCount == 0 || instanceCount == 0) return;
+
+    const glm::vec4 clip = vp * glm::vec4(center / (float)vertexCount, 1.0f);
+
+    // 深度テストは有効のまま、面より手前へ引いて重ねる（Z-fighting対策）
+    RenderQueue::Packet packet;
+    packet.program = m_queueSolidProg;
+    packet.offset = RenderQueue::Offset::Front;
+    packet.translucent = true;
+    packet.depth = (clip.w > 0.0f) ? clip.z / clip.w * 0.5f + 0.5f : 0.0f;
+    packet.vao = m_highlightVao;
+    packet.first = (GLint)(offset / sizeof(glm::vec3));
+    packet.count = (GLsizei)vertexCount;
+    packet.instanceCount = instanceCount;
+    packet.firstInstance = m_meshes[kEditMesh].firstInstance;
+    packet.color = color;
+    m_queue.submit(packet);
+}
@@ -1,46 +1,238 @@
 #pragma once
 
+#include "array"
+#include "span"
+#include "variant"
+#include "vector"
+
 #include "glm/glm.hpp"
 
-#include "render/line_mesh.h"
-#include "render/line_program.h"
+#include "mesh/edit_mesh.h"
+#include "render/face_mesh.h"
+#include "render/frame_uniforms.h"
+#include "render/geometry_pool.h"
+#include "render/instance_buffer.h"
 #include "render/mesh.h"
-#include "render/mesh_program.h"
+#include "render/render_queue.h"
+#include "render/shader_variants.h"
+#include "render/stream_buffer.h"
+#include "scene/scene.h"
+#include "select/face_selection.h"
 
 class Renderer
 {
 public:
+    // Scene::mesh() に入れるメッシュ番号
+    enum MeshId : uint32_t
+    {
+        kEditMesh = 0,
+        kPartMesh,      ///< 繰り返し配置する部品（インスタンス描画の確認用の立方体）
+        kMeshCount,
+    };
+
     Renderer();
     ~Renderer();
 
-    void init();
+    void init(const EditMesh& mesh);
     void destroy();
-    void draw(const glm::mat4& vp, int w, int h, uint32_t selectedFace);
+    void setMesh(const EditMesh& mesh);
+    /**
+     * @brief ワイヤ・ハイライトは mesh から、面は読み込み済みの頂点列から作る
+     *
+     * setMesh(mesh) の後に setSolidMesh() を呼ぶのと同じ結果になるが、EditMesh の面は作らない。
+     * CPU 側の構築・変換を済ませてから GL に送るので、途中で投げてもレンダラは元のまま。
+     */
+    void setMesh(const EditMesh& mesh, std::span<const Vertex> verts, std::span<const uint32_t> indices,
+        VertexFormat format = VertexFormat::Full,
+        std::span<const glm::vec3> normals = {}, std::span<const glm::vec2> texcoords = {});
+    /**
+     * @brief 編集メッシュの面を読み込み済みの頂点列で置き換える
+     *
+     * format が Packed / Quantized なら vertex_pack で変換してから送る（変換後の列は残さない）。
+     * normals / texcoords は verts と同じ並び（無ければ空）。法線があれば面に陰影を付ける。
+     */
+    void setSolidMesh(std::span<const Vertex> verts, std::span<const uint32_t> indices,
+        VertexFormat format = VertexFormat::Full,
+        std::span<const glm::vec3> normals = {}, std::span<const glm::vec2> texcoords = {});
+
+    /**
+     * @brief 編集メッシュの頂点移動を GPU 側へ反映する（部分更新）
+     *
+     * verts の頂点に対応する面・ワイヤ・ハイライト用の頂点だけを汚れ範囲に積み、
+     * 次の draw() の先頭で glBufferSubData でまとめて送る。
+     * 面が setSolidMesh() の頂点列（分割済み）なら、初回だけ EditMesh から作り直す。
+     */
+    void updatePositions(const EditMesh& mesh, std::span<const uint32_t> verts);
+    size_t lastUploadBytes() const { return m_lastUploadBytes; }
+
+    /**
+     * @brief 地面（y = 0）のグリッドを描くか
+     *
+     * グリッドはメッシュを持たず、grid.glsl が画面全体の三角形 1 枚から画素ごとに線を求める（範囲は無限）。
+     * cameraDistance（OrbitCamera::distance()）で一番細かい線の間隔と、遠くで消え始める距離が決まる。
+     */
+    void setGrid(bool visible, float cameraDistance)
+    {
+        m_gridVisible = visible;
+        m_gridDistance = cameraDistance;
+    }
+
+    /**
+     * @brief フレームのカメラ情報を uniform バッファへ書く（フレームに 1 回、ピッキング・draw() より前）
+     *
+     * 全プログラムが FrameUniformBuffer::kBinding から読むので、行列をプログラムごとに送る必要は無い。
+     */
+    void beginFrame(const FrameUniforms& frame) { m_frame.update(frame); }
+    const FrameUniforms& frameUniforms() const { return m_frame.data(); }
+
+    /// ピッキングなどが別のバッファを結び付けた後に、フレームのものへ戻す
+    void bindFrameUniforms() const { m_frame.bind(); }
 
-    GLuint cubeSolidVAO() const { return m_cubeSolidVAO; }
+    /**
+     * @brief シーンの全ノードを描画する
+     *
+     * 同じメッシュを指すノードはまとめて 1 回のインスタンス描画になる。
+     * 描画は RenderQueue に積んでからソートして実行する（プログラム・VAO ごとにまとまる）。
+     * 全メッシュはジオメトリプールの VAO 1 つから baseVertex 付きで描く。
+     * ワールド行列・色・ノード ID はメッシュ順に連結した 1 本のインスタンス VBO に入れ、
+     * scene.revision() が変わったときだけ作り直す。
+     * 選択・ホバーのハイライトは kEditMesh の全インスタンスに重ねる。
+     * 毎フレーム変わるデータ（カリング後のインスタンス・ハイライトの三角形）は
+     * ストリーム用リングバッファへ直接書き込む。
+     * scene.updateWorld() と beginFrame() は呼び出し側で済ませておくこと（ビューポートもそこから取る）。
+     *
+     * @param visible ノードごとの可視フラグ（frustum_cull::cull の結果）。
+     *                空なら全ノードを描く。指定時はカメラが動くたびに変わるので毎フレームストリームに書く
+     */
+    void draw(const Scene& scene, const FaceSelection& selection, uint32_t hoveredFace = 0,
+        std::span<const uint8_t> visible = {});
+
+    /**
+     * @brief 全インスタンスの面を、現在バインドされているプログラムで描く
+     *
+     * オブジェクトピッキング用。インスタンス属性（ID を含む）はプールの VAO に登録済み。
+     * 直前の draw() で同期したインスタンスを使う。
+     * 量子化メッシュの復元係数はプログラムの uPosScale / uPosBias に入れる。
+     */
+    void drawInstancedSolids(GLint locPosScale, GLint locPosBias) const;
+
+    const FaceMesh& faceMesh() const { return m_faceMesh; }
+    GeometryPool::Stats poolStats(VertexFormat format = VertexFormat::Full) const { return pool(format).stats(); }
+    StreamBuffer::Stats streamStats() const { return m_stream.stats(); }
+    RenderQueue::Stats queueStats() const { return m_queue.lastStats(); }
+    ShaderVariants::Stats lineVariantStats() const { return m_lineVariants.stats(); }
 
     Renderer(const Renderer&) = delete;
     Renderer& operator=(const Renderer&) = delete;
 
 private:
+    // 線と面のどちらか（または両方）を持つ描画単位。空のものは描かない
+    using SolidMesh = std::variant<Mesh<Vertex>, Mesh<PackedVertex>, Mesh<QuantizedVertex>>;
+
+    struct RenderMesh
+    {
+        Mesh<Vertex> lines;     ///< GL_LINES、インデックス無し
+        SolidMesh    solid;     ///< 頂点形式は読み込み時に選ぶ
+        GLuint   firstInstance = 0;     ///< m_instances 内の先頭
+        GLsizei  instanceCount = 0;
+        bool     shaded = false;        ///< 面に法線の陰影を付ける（法線付きの圧縮形式）
+
+        const MeshBase& solidBase() const
+        {
+            return std::visit([](const MeshBase& m) -> const MeshBase& { return m; }, solid);
+        }
+    };
+
+    // EditMesh から作るワイヤ・ハイライトの CPU 側データ（GL は触らない）
+    struct EditGeometry
+    {
+        std::vector<Vertex> lines;
+        VertexSlots   lineSlots;
+        FaceTriangles faceTris;
+        VertexSlots   faceSlots;
+    };
+
+    static EditGeometry buildEditGeometry(const EditMesh& mesh);
+    void uploadEditGeometry(EditGeometry&& geometry);
+
+    // 面の描画で形式ごとに変わる uniform（量子化の復元・陰影）
+    struct SolidUniforms
+    {
+        GLint posScale = -1;
+        GLint posBias = -1;
+        GLint shade = -1;
+    };
+
+    // 頂点形式ごとのプール。全メッシュの頂点・インデックスを持つ（RenderMesh より先に宣言して後に破棄する）
+    std::array<GeometryPool, (size_t)VertexFormat::Count> m_pools;
+
+    GeometryPool& pool(VertexFormat format) { return m_pools[(size_t)format]; }
+    const GeometryPool& pool(VertexFormat format) const { return m_pools[(size_t)format]; }
+
     // --- Line ---
-    LineProgram m_lineProg;
-    LineMesh    m_gridMesh;
-    LineMesh    m_cubeWireMesh;
+    // line.glsl の機能ビット（ShaderVariants の Mask。シェーダ先頭のコメントと同じ並び）
+    enum LineFeature : ShaderVariants::Mask
+    {
+        kLineInstanced = 1u << 0,   ///< INSTANCED
+        kLinePacked    = 1u << 1,   ///< PACKED_VERTEX（法線で陰影）
+        kLineQuantized = 1u << 2,   ///< QUANTIZED_POSITION
+        kLineDynamic   = 1u << 3,   ///< DYNAMIC（陰影・復元を uniform で切り替える代用）
+    };
+
+    ShaderVariants m_lineVariants;  ///< 線・面
+
+    // --- Grid ---
+    GLuint m_gridProg = 0;
+    GLint  m_gridLocDistance = -1;
+    GLuint m_gridVao = 0;               ///< 属性なし（頂点はシェーダが gl_VertexID から作る）
+    bool   m_gridVisible = true;
+    float  m_gridDistance = 5.0f;
+    float  m_gridUploaded = -1.0f;      ///< 前回送った uCameraDistance
 
     // --- Mesh ---
-    MeshProgram m_meshProg;
-    Mesh m_cubeMesh;
+    std::array<RenderMesh, kMeshCount> m_meshes;
+
+    // --- Instances ---
+    InstanceBuffer m_instances;         ///< 全メッシュ分を MeshId 順に連結
+    uint64_t m_sceneRevision = ~0ull;
+    bool     m_instancesStale = true;   ///< メッシュを作り直したので再同期が必要
+    std::vector<InstanceData> m_instanceUpload;    ///< カリングしないときの静的アップロード用
+
+    // --- Per-frame streaming ---
+    StreamBuffer m_stream;
+    FrameUniformBuffer m_frame;
+
+    // --- Draw submission ---
+    RenderQueue m_queue;
+    static constexpr uint16_t kNoQueueProgram = 0xFFFF;
+    std::array<uint16_t, ShaderVariants::kVariantCount> m_queueLinePrograms;   ///< バリアント → キューの番号
+    uint16_t    m_queueSolidProg = 0;   ///< m_solidProg（ハイライト）
+    uint16_t    m_queueGridProg = 0;
 
     // --- Solid highlight ---
-    GLuint m_cubeSolidVAO = 0;
-    GLuint m_cubeSolidVBO = 0;
+    FaceMesh m_faceMesh;
+    FaceTriangles m_faceTris;   ///< ハイライト用に CPU 側にも残す（選択面だけをストリームへ書く）
+    DirtyRanges   m_faceDirty;  ///< m_faceTris.positions のうち未送信の範囲
+
+    // --- Partial updates ---
+    VertexSlots m_lineSlots;    ///< EditMesh の頂点 → ワイヤ頂点
+    VertexSlots m_faceSlots;    ///< EditMesh の頂点 → m_faceTris の頂点
+    bool   m_solidFromEditMesh = false;     ///< false なら面の頂点番号は EditMesh と対応しない
+    size_t m_lastUploadBytes = 0;
+    GLuint m_highlightVao = 0;  ///< 位置はストリーム、インスタンス属性は編集メッシュの範囲
 
-    GLuint m_solidProg = 0;
-    GLint  m_solidLocMVP = -1;
+    GLuint m_solidProg = 0;     ///< INSTANCED
     GLint  m_solidLocColor = -1;
 
     void createSolidShader();
-    void generateCubeSolidMesh();
-    void drawSelectedFaceFill(const glm::mat4& vp, uint32_t selectedFace);
-};
\ No newline at end of file
+    void submitGrid();
+    uint16_t lineProgram(ShaderVariants::Mask mask);
+    void flushEdits();
+    bool instancesDirty(const Scene& scene, std::span<const uint8_t> visible) const;
+    uint32_t countInstances(const Scene& scene, std::span<const uint8_t> visible);
+    void fillInstances(const Scene& scene, std::span<const uint8_t> visible, uint32_t total);
+    size_t highlightVertexCount(std::span<const uint32_t> faceIds) const;
+    void submitMeshes();
+    void submitFaceFill(const glm::mat4& vp, std::span<const uint32_t> faceIds, const glm::vec4& color);
+    void drawSolids(const SolidUniforms& uniforms) const;
+};
@@ -1,5 +1,6 @@
 #include "shader_utils.h"
 
+#include "algorithm"
 #include "vector"
 #include "fstream"
 #include "sstream"
@@ -40,18 +41,26 @@ static std::string InjectDefineAfterVersion(const std::string& src, const char*
     return out;
 }
 
-GLuint shader_utils::BuildProgramFromGLSLFile(const char* path)
+GLuint shader_utils::BuildProgramFromGLSLFile(const char* path, std::string_view defines)
 {
-    const std::string src = ReadTextFile(path);
+    return BuildProgramFromGLSLSource(ReadTextFile(path), defines);
+}
+
+GLuint shader_utils::BuildProgramFromGLSLSource(std::string_view source, std::string_view defines, bool retrievable)
+{
+    const std::string src(source);
 
-    const std::string vsSrc = InjectDefineAfterVersion(src, "#define VERTEX 1");
-    const std::string fsSrc = InjectDefineAfterVersion(src, "#define FRAGMENT 1");
+    std::string extra(defines);
+    if (!extra.empty() && extra.back() != '\n') extra += '\n';
+
+    const std::string vsSrc = InjectDefineAfterVersion(src, ("#define VERTEX 1\n" + extra).c_str());
+    const std::string fsSrc = InjectDefineAfterVersion(src, ("#define FRAGMENT 1\n" + extra).c_str());
 
     GLuint vs = CompileShader(GL_VERTEX_SHADER, vsSrc.c_str());
     GLuint fs = CompileShader(GL_FRAGMENT_SHADER, fsSrc.c_str());
     if (!vs || !fs) throw std::runtime_error("Shader compile failed");
 
-    GLuint prog = LinkProgram(vs, fs);
+    GLuint prog = LinkProgram(vs, fs, retrievable);
     glDeleteShader(vs);
     glDeleteShader(fs);
     if (!prog) throw std::runtime_error("Program link failed");
@@ -59,6 +68,71 @@ GLuint shader_utils::BuildProgramFromGLSLFile(const char* path)
     return prog;
 }
 
+GLuint shader_utils::StartProgramFromGLSLSource(std::string_view source, std::string_view defines, bool retrievable,
+    GLuint& vs, GLuint& fs)
+{
+    const std::string src(source);
+
+    std::string extra(defines);
+    if (!extra.empty() && extra.back() != '\n') extra += '\n';
+
+    const std::string vsSrc = InjectDefineAfterVersion(src, ("#define VERTEX 1\n" + extra).c_str());
+    const std::string fsSrc = InjectDefineAfterVersion(src, ("#define FRAGMENT 1\n" + extra).c_str());
+
+    // 状態を問い合わせた時点で完了待ちになるので、ここでは発行だけ
+    const char* vsText = vsSrc.c_str();
+    const char* fsText = fsSrc.c_str();
+    vs = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vs, 1, &vsText, nullptr);
+    glCompileShader(vs);
+    fs = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fs, 1, &fsText, nullptr);
+    glCompileShader(fs);
+
+    GLuint p = glCreateProgram();
+    if (retrievable && glProgramParameteri) glProgramParameteri(p, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(p, vs);
+    glAttachShader(p, fs);
+    glLinkProgram(p);
+    return p;
+}
+
+GLuint shader_utils::FinishProgram(GLuint program, GLuint vs, GLuint fs)
+{
+    GLint ok = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok)
+    {
+        // コンパイルエラーの方が原因を特定しやすいので先に出す
+        for (GLuint s : { vs, fs })
+        {
+            GLint compiled = 0;
+            glGetShaderiv(s, GL_COMPILE_STATUS, &compiled);
+            if (compiled) continue;
+            GLint len = 0;
+            glGetShaderiv(s, GL_INFO_LOG_LENGTH, &len);
+            std::vector<char> log((size_t)std::max(len, 1));
+            glGetShaderInfoLog(s, (GLsizei)log.size(), nullptr, log.data());
+            std::fprintf(stderr, "Shader compile error: %s\n", log.data());
+        }
+
+        GLint len = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &len);
+        std::vector<char> log((size_t)std::max(len, 1));
+        glGetProgramInfoLog(program, (GLsizei)log.size(), nullptr, log.data());
+        std::fprintf(stderr, "Program link error: %s\n", log.data());
+    }
+
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    if (!ok)
+    {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
 GLuint shader_utils::CompileShader(GLenum type, const char* src)
 {
     GLuint s = glCreateShader(type);
@@ -80,9 +154,10 @@ GLuint shader_utils::CompileShader(GLenum type, const char* src)
     return s;
 }
 
-GLuint shader_utils::LinkProgram(GLuint vs, GLuint fs)
+GLuint shader_utils::LinkProgram(GLuint vs, GLuint fs, bool retrievable)
 {
     GLuint p = glCreateProgram();
+    if (retrievable && glProgramParameteri) glProgramParameteri(p, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glAttachShader(p, vs);
     glAttachShader(p, fs);
     glLinkProgram(p);
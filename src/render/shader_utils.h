@@ -7,9 +7,35 @@
 namespace shader_utils
 {
     std::string ReadTextFile(const char* path);
-    GLuint BuildProgramFromGLSLFile(const char* path);
+
+    /**
+     * @brief 1 ファイルに VERTEX / FRAGMENT をまとめた GLSL からプログラムを作る
+     *
+     * @param defines 追加の "#define ..." 行（改行区切り）。#version 直後に差し込む
+     */
+    GLuint BuildProgramFromGLSLFile(const char* path, std::string_view defines = {});
+
+    /**
+     * @brief 読み込み済みの GLSL から作る（BuildProgramFromGLSLFile の本体）
+     *
+     * @param retrievable glGetProgramBinary で取り出すつもりならリンク前にヒントを立てる
+     */
+    GLuint BuildProgramFromGLSLSource(std::string_view src, std::string_view defines = {}, bool retrievable = false);
+
+    /**
+     * @brief コンパイル・リンクを発行するだけで結果を待たない（並列コンパイル用）
+     *
+     * vs / fs は FinishProgram() に渡すまで残しておく。
+     * 完了したかは GL_COMPLETION_STATUS_KHR で確かめられる（拡張がある場合）。
+     */
+    GLuint StartProgramFromGLSLSource(std::string_view src, std::string_view defines, bool retrievable,
+        GLuint& vs, GLuint& fs);
+
+    /// リンク結果を確かめてシェーダを削除する。失敗ならログを出してプログラムも削除し 0 を返す
+    GLuint FinishProgram(GLuint program, GLuint vs, GLuint fs);
+
     GLuint CompileShader(GLenum type, const char* src);
-    GLuint LinkProgram(GLuint vs, GLuint fs);
+    GLuint LinkProgram(GLuint vs, GLuint fs, bool retrievable = false);
     GLuint BuildProgramFromSource(
         std::string_view vsSrc,
         std::string_view fsSrc);
@@ -0,0 +1,107 @@
+#include "shader_variants.h"
+
+#include "algorithm"
+#include "stdexcept"
+
+#include "program_registry.h"
+
+ShaderVariants::~ShaderVariants()
+{
+    destroy();
+}
+
+void ShaderVariants::create(const char* path, std::span<const char* const> features, std::span<const char* const> uniforms)
+{
+    if (features.size() > kMaxFeatures) throw std::runtime_error("ShaderVariants::create too many features");
+    if (uniforms.size() > kMaxUniforms) throw std::runtime_error("ShaderVariants::create too many uniforms");
+
+    destroy();
+    m_path = path;
+    m_features.assign(features.begin(), features.end());
+    m_uniforms.assign(uniforms.begin(), uniforms.end());
+}
+
+void ShaderVariants::destroy()
+{
+    for (Slot& s : m_slots)
+    {
+        if (s.state != State::None) program_registry::release(s.variant.program);
+        s = {};
+    }
+    m_pending.clear();
+    m_stats = {};
+}
+
+ShaderVariants::Mask ShaderVariants::request(Mask mask, Mask fallback)
+{
+    if (mask >= kVariantCount || fallback >= kVariantCount)
+        throw std::runtime_error("ShaderVariants::request mask out of range");
+
+    Slot& slot = m_slots[mask];
+    if (slot.state == State::Ready) return mask;
+    if (slot.state == State::None) start(mask);
+    if (slot.state == State::Ready) return mask;   // ディスクキャッシュから即座に出来た
+
+    // 代用は待ってでも用意する（描けないよりは良い。普通は init で先に作っておく）
+    Slot& fb = m_slots[fallback];
+    if (fb.state == State::None) start(fallback);
+    if (fb.state == State::Pending) complete(fallback);
+
+    ++m_stats.fallbacks;
+    return fallback;
+}
+
+void ShaderVariants::update()
+{
+    // 並列コンパイルが無いと完了まで待つことになるので、1 回に 1 つだけ仕上げる
+    bool mayWait = !program_registry::parallelCompile();
+    for (size_t i = 0; i < m_pending.size();)
+    {
+        const Mask mask = m_pending[i];
+        if (program_registry::ready(m_slots[mask].variant.program, mayWait))
+        {
+            mayWait = false;
+            complete(mask);     // m_pending から外れる
+            continue;
+        }
+        ++i;
+    }
+}
+
+std::string ShaderVariants::defines(Mask mask) const
+{
+    std::string out;
+    for (size_t i = 0; i < m_features.size(); ++i)
+        if (mask & (Mask(1) << i)) out += "#define " + m_features[i] + " 1\n";
+    return out;
+}
+
+void ShaderVariants::start(Mask mask)
+{
+    Slot& slot = m_slots[mask];
+    slot.variant.program = program_registry::acquireAsync(m_path.c_str(), defines(mask));
+    slot.variant.locations.fill(-1);
+    slot.state = State::Pending;
+    ++m_stats.pending;
+    m_pending.push_back(mask);
+
+    // バイナリキャッシュから作れたもの（または既に他で作ってあったもの）はもう出来ている
+    if (program_registry::ready(slot.variant.program))
+        complete(mask);
+}
+
+void ShaderVariants::complete(Mask mask)
+{
+    Slot& slot = m_slots[mask];
+    if (slot.state != State::Pending) return;
+
+    program_registry::ready(slot.variant.program, true);    // まだなら完了まで待つ
+
+    for (size_t i = 0; i < m_uniforms.size(); ++i)
+        slot.variant.locations[i] = glGetUniformLocation(slot.variant.program, m_uniforms[i].c_str());
+
+    slot.state = State::Ready;
+    --m_stats.pending;
+    ++m_stats.ready;
+    m_pending.erase(std::remove(m_pending.begin(), m_pending.end(), mask), m_pending.end());
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "array"
+#include "cstdint"
+#include "span"
+#include "string"
+#include "vector"
+
+#include "glad/glad.h"
+
+/**
+ * @brief 1 つの GLSL ファイルを機能ビットの組み合わせ（バリアント）ごとに作り分ける
+ *
+ * create() に渡した機能名の i 番目がビット i。立っているビットごとに "#define NAME 1" を
+ * #version の直後へ差し込む（VERTEX / FRAGMENT と同じ仕組み）。
+ * uniform で分岐する代わりに、よく使う組み合わせを専用のプログラムにできる。
+ *
+ * - バリアントは request() で初めて要求されたときに作り始める（起動時に全部は作らない）
+ * - 出来上がるまでは呼び出し側が指定した代用（fallback）のバリアントを返す。代用はその場で同期して作る
+ * - 作成は program_registry::acquireAsync() 経由（共有・ディスクキャッシュもそちら）。
+ *   並列コンパイル拡張があれば update() は待たずに完了を確かめ、無ければ 1 回に 1 つずつ同期して仕上げる
+ * - uniform の位置はバリアントごとに create() の uniforms の順で覚える（無ければ -1）
+ */
+class ShaderVariants
+{
+public:
+    using Mask = uint32_t;
+
+    static constexpr size_t kMaxFeatures = 6;   ///< 64 通り
+    static constexpr size_t kMaxUniforms = 8;
+    static constexpr size_t kVariantCount = size_t(1) << kMaxFeatures;
+
+    struct Variant
+    {
+        GLuint program = 0;
+        std::array<GLint, kMaxUniforms> locations;
+    };
+
+    struct Stats
+    {
+        uint32_t ready = 0;         ///< 使えるバリアント数
+        uint32_t pending = 0;       ///< 作成中
+        uint32_t fallbacks = 0;     ///< request() が代用を返した回数（累計）
+    };
+
+    ShaderVariants() = default;
+    ~ShaderVariants();
+
+    ShaderVariants(const ShaderVariants&) = delete;
+    ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+    void create(const char* path, std::span<const char* const> features, std::span<const char* const> uniforms);
+    void destroy();
+
+    /**
+     * @brief mask のバリアントを要求する
+     *
+     * @return 今使えるバリアントのマスク（mask が出来ていなければ fallback）
+     */
+    Mask request(Mask mask, Mask fallback);
+
+    /// 作成中のバリアントの完了を確かめる（1 フレームに 1 回）
+    void update();
+
+    bool ready(Mask mask) const { return mask < kVariantCount && m_slots[mask].state == State::Ready; }
+
+    /// ready() なバリアントのみ
+    const Variant& variant(Mask mask) const { return m_slots[mask].variant; }
+
+    Stats stats() const { return m_stats; }
+
+private:
+    enum class State : uint8_t { None, Pending, Ready };
+
+    struct Slot
+    {
+        State   state = State::None;
+        Variant variant;
+    };
+
+    std::string m_path;
+    std::vector<std::string> m_features;
+    std::vector<std::string> m_uniforms;
+    std::array<Slot, kVariantCount> m_slots;
+    std::vector<Mask> m_pending;    ///< 要求された順
+    Stats m_stats;
+
+    std::string defines(Mask mask) const;
+    void start(Mask mask);
+    void complete(Mask mask);
+};
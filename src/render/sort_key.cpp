@@ -0,0 +1,90 @@
+#include "sort_key.h"
+
+#include "array"
+#include "cmath"
+
+namespace
+{
+    constexpr uint32_t kIdMask = (1u << sort_key::kIdBits) - 1;
+    constexpr uint32_t kDepthMax = (1u << sort_key::kDepthBits) - 1;
+
+    constexpr uint32_t kPassShift = 64 - sort_key::kPassBits;
+    constexpr uint32_t kTranslucentShift = kPassShift - 1;
+}
+
+uint32_t sort_key::quantizeDepth(float depth01)
+{
+    if (!(depth01 > 0.0f)) return 0;    // NaN も手前扱い
+    if (depth01 >= 1.0f) return kDepthMax;
+    return (uint32_t)std::lround(depth01 * (float)kDepthMax);
+}
+
+uint64_t sort_key::opaque(uint32_t pass, uint32_t program, uint32_t vao, float depth01)
+{
+    return (uint64_t)pass << kPassShift
+        | (uint64_t)(program & kIdMask) << 48
+        | (uint64_t)(vao & kIdMask) << 36
+        | (uint64_t)quantizeDepth(depth01) << 12;
+}
+
+uint64_t sort_key::translucent(uint32_t pass, uint32_t program, uint32_t vao, float depth01)
+{
+    return (uint64_t)pass << kPassShift
+        | 1ull << kTranslucentShift
+        | (uint64_t)(kDepthMax - quantizeDepth(depth01)) << 36
+        | (uint64_t)(program & kIdMask) << 24
+        | (uint64_t)(vao & kIdMask) << 12;
+}
+
+uint32_t sort_key::passOf(uint64_t key)
+{
+    return (uint32_t)(key >> kPassShift);
+}
+
+bool sort_key::isTranslucent(uint64_t key)
+{
+    return (key >> kTranslucentShift) & 1;
+}
+
+void sort_key::radixSort(std::vector<Entry>& entries, std::vector<Entry>& scratch)
+{
+    const size_t n = entries.size();
+    if (n < 2) return;
+
+    // 8 バイト分のヒストグラムを 1 回の走査で作る
+    std::array<std::array<uint32_t, 256>, 8> counts{};
+    for (const Entry& e : entries)
+    {
+        for (int b = 0; b < 8; ++b)
+            ++counts[b][(e.key >> (b * 8)) & 0xFF];
+    }
+
+    scratch.resize(n);
+    Entry* src = entries.data();
+    Entry* dst = scratch.data();
+
+    for (int b = 0; b < 8; ++b)
+    {
+        std::array<uint32_t, 256>& c = counts[b];
+
+        // このバイトが全要素で同じなら並びは変わらない
+        const uint32_t first = (uint32_t)((src[0].key >> (b * 8)) & 0xFF);
+        if (c[first] == n) continue;
+
+        uint32_t sum = 0;
+        for (uint32_t& v : c)
+        {
+            const uint32_t count = v;
+            v = sum;
+            sum += count;
+        }
+
+        const int shift = b * 8;
+        for (size_t i = 0; i < n; ++i)
+            dst[c[(src[i].key >> shift) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+    }
+
+    if (src != entries.data())
+        entries.swap(scratch);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "cstdint"
+#include "vector"
+
+/**
+ * @brief 描画パケットの 64 bit ソートキーと基数ソート
+ *
+ * キーの並び（上位から）:
+ *
+ *   不透明: pass(3) | 0 | program(12) | vao(12) | depth(24) | 0(12)
+ *   半透明: pass(3) | 1 | ~depth(24)  | program(12) | vao(12) | 0(12)
+ *
+ * 昇順に並べると pass ごとに不透明 → 半透明の順になり、
+ * 不透明はプログラム・VAO でまとまり（ステート切り替えが最少）、同じ組の中では手前から、
+ * 半透明は奥から手前へ並ぶ。program / vao は下位 12 bit だけを使う（衝突しても並びが粗くなるだけ）。
+ * GL には依存しない。
+ */
+namespace sort_key
+{
+    constexpr uint32_t kPassBits = 3;
+    constexpr uint32_t kIdBits = 12;
+    constexpr uint32_t kDepthBits = 24;
+
+    struct Entry
+    {
+        uint64_t key = 0;
+        uint32_t index = 0;     ///< パケット配列の番号
+    };
+
+    /// depth01 は [0, 1]（0 が手前）。範囲外は丸める
+    uint32_t quantizeDepth(float depth01);
+
+    uint64_t opaque(uint32_t pass, uint32_t program, uint32_t vao, float depth01);
+    uint64_t translucent(uint32_t pass, uint32_t program, uint32_t vao, float depth01);
+
+    uint32_t passOf(uint64_t key);
+    bool isTranslucent(uint64_t key);
+
+    /**
+     * @brief キーの昇順に安定ソートする（LSD 基数ソート、8 bit × 8 回）
+     *
+     * 全要素で同じ値のバイトは飛ばすので、実際の回数は使っているビット数で決まる。
+     * scratch は作業用（呼び出し側で使い回すと毎フレームの確保が無くなる）。
+     */
+    void radixSort(std::vector<Entry>& entries, std::vector<Entry>& scratch);
+}
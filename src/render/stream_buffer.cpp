@@ -0,0 +1,138 @@
+#include "stream_buffer.h"
+
+#include "algorithm"
+#include "stdexcept"
+
+#include "render/gl_state.h"
+
+StreamBuffer::~StreamBuffer()
+{
+    destroy();
+}
+
+void StreamBuffer::init(size_t segmentBytes)
+{
+    destroy();
+
+    glGenBuffers(1, &m_buffer);
+    allocateStorage(segmentBytes);
+}
+
+void StreamBuffer::destroy()
+{
+    if (m_mapped) unmap();
+    clearFences();
+
+    if (m_buffer) gl_state::deleteBuffer(m_buffer);
+    m_buffer = 0;
+    m_segmentBytes = 0;
+    m_segment = 0;
+    m_cursor = 0;
+    m_waits = 0;
+    m_grows = 0;
+}
+
+void StreamBuffer::beginFrame(size_t bytesNeeded)
+{
+    if (!m_buffer) throw std::runtime_error("StreamBuffer::beginFrame called before init");
+
+    if (bytesNeeded > m_segmentBytes)
+    {
+        // 描画中の区画があっても glBufferData で孤児化すればドライバは待たない
+        allocateStorage(std::max(bytesNeeded + bytesNeeded / 2, m_segmentBytes * 2));
+        ++m_grows;
+        return;
+    }
+
+    m_segment = (m_segment + 1) % kSegments;
+    m_cursor = 0;
+
+    GLsync& fence = m_fences[m_segment];
+    if (!fence) return;
+
+    // 3 フレーム前の描画が終わっていれば即座に返る
+    GLenum r = glClientWaitSync(fence, 0, 0);
+    if (r == GL_TIMEOUT_EXPIRED)
+    {
+        ++m_waits;
+        do
+        {
+            r = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);   // 1 ms
+        } while (r == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::endFrame()
+{
+    if (!m_buffer) return;
+
+    GLsync& fence = m_fences[m_segment];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void* StreamBuffer::map(size_t bytes, size_t align, size_t& offset)
+{
+    if (m_mapped) throw std::runtime_error("StreamBuffer::map called while already mapped");
+
+    const size_t segmentBase = (size_t)m_segment * m_segmentBytes;
+    align = std::max<size_t>(align, 1);
+
+    // 区画の先頭ではなくバッファ先頭基準で揃える（offset / stride を first に使うため）
+    const size_t begin = (segmentBase + m_cursor + align - 1) / align * align;
+    if (begin + bytes > segmentBase + m_segmentBytes)
+        throw std::runtime_error("StreamBuffer::map exceeds the frame segment (pass the total to beginFrame)");
+
+    offset = begin;
+    m_cursor = begin + bytes - segmentBase;
+    if (bytes == 0) return nullptr;
+
+    gl_state::bindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    void* ptr = glMapBufferRange(GL_COPY_WRITE_BUFFER, (GLintptr)begin, (GLsizeiptr)bytes,
+        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (!ptr) throw std::runtime_error("StreamBuffer::map glMapBufferRange failed");
+    m_mapped = true;
+    return ptr;
+}
+
+void StreamBuffer::unmap()
+{
+    if (!m_mapped) return;
+
+    gl_state::bindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    m_mapped = false;
+}
+
+StreamBuffer::Stats StreamBuffer::stats() const
+{
+    Stats s;
+    s.segmentBytes = m_segmentBytes;
+    s.usedBytes = m_cursor;
+    s.waits = m_waits;
+    s.grows = m_grows;
+    return s;
+}
+
+void StreamBuffer::allocateStorage(size_t segmentBytes)
+{
+    // 区画の境界をどのストライドでも揃えやすいよう 256 バイト単位にする
+    m_segmentBytes = (segmentBytes + 255) / 256 * 256;
+    m_segment = 0;
+    m_cursor = 0;
+    clearFences();
+
+    gl_state::bindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(m_segmentBytes * kSegments), nullptr, GL_STREAM_DRAW);
+}
+
+void StreamBuffer::clearFences()
+{
+    for (GLsync& fence : m_fences)
+    {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "array"
+#include "cstddef"
+#include "cstdint"
+
+#include "glad/glad.h"
+
+/**
+ * @brief 毎フレーム書き換える頂点データ用のリングバッファ（3 区画）
+ *
+ * 1 本のバッファを kSegments 個の区画に分け、フレームごとに次の区画へ進む。
+ * 区画を使い終えたら glFenceSync で囲い、再利用する直前にだけそのフェンスを待つ。
+ * GPU が 2 フレーム以上遅れない限り待ちは発生しない。
+ *
+ * GL 3.3 には永続マップが無いので、確保ごとに
+ * GL_MAP_UNSYNCHRONIZED_BIT で区画内の範囲だけをマップする。
+ * ドライバ側の同期・再確保は起きず、呼び出し側はマップ先へ直接書き込む。
+ *
+ *   ring.beginFrame(bytes);            // 今フレームの合計を先に渡す（足りなければここで拡張）
+ *   auto* p = (T*)ring.map(n * sizeof(T), sizeof(T), offset);
+ *   ...書き込み...
+ *   ring.unmap();
+ *   ...offset を使って描画...
+ *   ring.endFrame();
+ */
+class StreamBuffer
+{
+public:
+    static constexpr int kSegments = 3;
+
+    struct Stats
+    {
+        size_t   segmentBytes = 0;
+        size_t   usedBytes = 0;         ///< 今フレームの区画で使った量
+        uint32_t waits = 0;             ///< フェンスがまだ通っておらず待った回数（累計）
+        uint32_t grows = 0;
+    };
+
+    StreamBuffer() = default;
+    ~StreamBuffer();
+
+    void init(size_t segmentBytes);
+    void destroy();
+
+    /**
+     * @brief 次の区画へ進む
+     *
+     * @param bytesNeeded 今フレームで map() する合計（アラインメントの余白込みの見積もり）。
+     *                    区画より大きければ全体を作り直す（旧ストレージは孤児化するので待たない）
+     */
+    void beginFrame(size_t bytesNeeded = 0);
+    void endFrame();
+
+    /**
+     * @brief 現在の区画から bytes を切り出してマップする
+     *
+     * @param align  offset の倍数（頂点ストライドを渡せば offset / stride を first に使える）
+     * @param offset バッファ先頭からのバイト位置（描画時の属性 offset に使う）
+     *
+     * 区画に入らなければ例外。unmap() するまで他の map() は呼ばないこと。
+     */
+    void* map(size_t bytes, size_t align, size_t& offset);
+    void unmap();
+
+    GLuint buffer() const { return m_buffer; }
+    Stats stats() const;
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+private:
+    GLuint m_buffer = 0;
+    size_t m_segmentBytes = 0;
+    int    m_segment = 0;
+    size_t m_cursor = 0;                ///< 区画内の使用量
+    bool   m_mapped = false;
+
+    std::array<GLsync, kSegments> m_fences{};
+
+    uint32_t m_waits = 0;
+    uint32_t m_grows = 0;
+
+    void allocateStorage(size_t segmentBytes);
+    void clearFences();
+};
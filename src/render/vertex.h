@@ -1,5 +1,7 @@
 #pragma once
 
+#include "cstdint"
+
 #include "glm/glm.hpp"
 
 struct Vertex
@@ -7,3 +9,41 @@ struct Vertex
     glm::vec3 position;
     glm::vec4 color;
 };
+
+/**
+ * @brief 圧縮頂点（24 バイト）
+ *
+ * 法線・UV 付きを float のまま持つと 48 バイトになるところを半分にする。
+ *   color  : RGBA8（正規化）
+ *   normal : 八面体符号化した snorm16 × 2
+ *   uv     : half × 2
+ */
+struct PackedVertex
+{
+    glm::vec3 position;
+    uint32_t  color;
+    uint32_t  normal;
+    uint32_t  uv;
+};
+
+/// PackedVertex の位置をメッシュの AABB 基準の unorm16 × 3 にしたもの（20 バイト）
+struct QuantizedVertex
+{
+    uint16_t position[3];
+    uint16_t pad;
+    uint32_t color;
+    uint32_t normal;
+    uint32_t uv;
+};
+
+static_assert(sizeof(PackedVertex) == 24, "PackedVertex must stay tightly packed");
+static_assert(sizeof(QuantizedVertex) == 20, "QuantizedVertex must stay tightly packed");
+
+/// GeometryPool 1 つにつき 1 形式（VAO の属性設定が形式で決まる）
+enum class VertexFormat : uint32_t
+{
+    Full = 0,       ///< Vertex
+    Packed,         ///< PackedVertex
+    Quantized,      ///< QuantizedVertex
+    Count,
+};
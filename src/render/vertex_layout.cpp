@@ -0,0 +1,11 @@
+#include "vertex_layout.h"
+
+void vertex_layout::apply(const VertexLayoutView& layout)
+{
+    for (const VertexAttribute& a : layout.attributes)
+    {
+        glEnableVertexAttribArray(a.location);
+        glVertexAttribPointer(a.location, a.components, a.type, a.normalized ? GL_TRUE : GL_FALSE,
+            (GLsizei)layout.stride, (void*)(size_t)a.offset);
+    }
+}
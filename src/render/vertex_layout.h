@@ -0,0 +1,154 @@
+#pragma once
+
+#include "array"
+#include "concepts"
+#include "cstddef"
+#include "cstdint"
+#include "span"
+
+#include "glad/glad.h"
+#include "glm/glm.hpp"
+
+#include "render/vertex.h"
+
+// 頂点属性の location（2..7 はインスタンス属性 = InstanceBuffer）
+namespace vertex_location
+{
+    constexpr GLuint kPosition = 0;
+    constexpr GLuint kColor = 1;
+    constexpr GLuint kNormal = 8;      ///< 八面体符号化（圧縮形式）
+    constexpr GLuint kTexcoord = 9;    ///< half（圧縮形式）
+    constexpr GLuint kFaceId = 10;     ///< 面 ID + 1（FaceMesh の別バッファ、整数属性）
+}
+
+/// 頂点属性 1 つ分（glVertexAttribPointer の引数）
+struct VertexAttribute
+{
+    GLuint   location;
+    GLint    components;
+    GLenum   type;
+    bool     normalized;
+    uint32_t offset;
+};
+
+/// 実行時に扱うための型消去したレイアウト（表自体は constexpr の静的配列）
+struct VertexLayoutView
+{
+    uint32_t stride = 0;
+    std::span<const VertexAttribute> attributes;
+};
+
+/**
+ * @brief 頂点型ごとの属性表（コンパイル時に決まる）
+ *
+ * 特殊化で kAttributes を定義する。GeometryPool に入れられる型は kFormat も持つ。
+ * 表の妥当性（stride 内に収まる・属性のバイト範囲や location が重ならない・インスタンス属性と衝突しない）は
+ * static_assert で検査するので、実行時に型情報を調べることはない。
+ */
+template <class V>
+struct VertexLayout;
+
+template <>
+struct VertexLayout<Vertex>
+{
+    static constexpr VertexFormat kFormat = VertexFormat::Full;
+    static constexpr std::array kAttributes{
+        VertexAttribute{ vertex_location::kPosition, 3, GL_FLOAT, false, offsetof(Vertex, position) },
+        VertexAttribute{ vertex_location::kColor,    4, GL_FLOAT, false, offsetof(Vertex, color) },
+    };
+};
+
+template <>
+struct VertexLayout<PackedVertex>
+{
+    static constexpr VertexFormat kFormat = VertexFormat::Packed;
+    static constexpr std::array kAttributes{
+        VertexAttribute{ vertex_location::kPosition, 3, GL_FLOAT,         false, offsetof(PackedVertex, position) },
+        VertexAttribute{ vertex_location::kColor,    4, GL_UNSIGNED_BYTE, true,  offsetof(PackedVertex, color) },
+        VertexAttribute{ vertex_location::kNormal,   2, GL_SHORT,         true,  offsetof(PackedVertex, normal) },
+        VertexAttribute{ vertex_location::kTexcoord, 2, GL_HALF_FLOAT,    false, offsetof(PackedVertex, uv) },
+    };
+};
+
+template <>
+struct VertexLayout<QuantizedVertex>
+{
+    // unorm16 → [0, 1]。シェーダで uPosScale / uPosBias を掛けて戻す
+    static constexpr VertexFormat kFormat = VertexFormat::Quantized;
+    static constexpr std::array kAttributes{
+        VertexAttribute{ vertex_location::kPosition, 3, GL_UNSIGNED_SHORT, true,  offsetof(QuantizedVertex, position) },
+        VertexAttribute{ vertex_location::kColor,    4, GL_UNSIGNED_BYTE,  true,  offsetof(QuantizedVertex, color) },
+        VertexAttribute{ vertex_location::kNormal,   2, GL_SHORT,          true,  offsetof(QuantizedVertex, normal) },
+        VertexAttribute{ vertex_location::kTexcoord, 2, GL_HALF_FLOAT,     false, offsetof(QuantizedVertex, uv) },
+    };
+};
+
+/// 位置のみ（FaceMesh・ハイライト用）。プールには入れないので kFormat は無い
+template <>
+struct VertexLayout<glm::vec3>
+{
+    static constexpr std::array kAttributes{
+        VertexAttribute{ vertex_location::kPosition, 3, GL_FLOAT, false, 0 },
+    };
+};
+
+template <class V>
+concept HasVertexLayout = requires { VertexLayout<V>::kAttributes; };
+
+template <class V>
+concept PoolVertex = HasVertexLayout<V> && requires { { VertexLayout<V>::kFormat } -> std::convertible_to<VertexFormat>; };
+
+namespace vertex_layout
+{
+    constexpr uint32_t componentBytes(GLenum type)
+    {
+        switch (type)
+        {
+        case GL_UNSIGNED_BYTE: case GL_BYTE: return 1;
+        case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: return 2;
+        default: return 4;
+        }
+    }
+
+    template <class V>
+    constexpr bool isValid()
+    {
+        const auto& attrs = VertexLayout<V>::kAttributes;
+        for (size_t i = 0; i < attrs.size(); ++i)
+        {
+            const VertexAttribute& a = attrs[i];
+            const uint32_t aEnd = a.offset + a.components * componentBytes(a.type);
+            if (aEnd > sizeof(V)) return false;
+            if (a.location >= 2 && a.location <= 7) return false;   // インスタンス属性と衝突
+            for (size_t j = i + 1; j < attrs.size(); ++j)
+            {
+                const VertexAttribute& b = attrs[j];
+                if (b.location == a.location) return false;
+                // [offset, offset + size) が重なる
+                const uint32_t bEnd = b.offset + b.components * componentBytes(b.type);
+                if (a.offset < bEnd && b.offset < aEnd) return false;
+            }
+        }
+        return true;
+    }
+
+    template <HasVertexLayout V>
+    constexpr VertexLayoutView of()
+    {
+        static_assert(isValid<V>(), "vertex layout overlaps, exceeds the stride or uses an instance location");
+        return { (uint32_t)sizeof(V), VertexLayout<V>::kAttributes };
+    }
+
+    constexpr VertexLayoutView of(VertexFormat format)
+    {
+        switch (format)
+        {
+        case VertexFormat::Packed:    return of<PackedVertex>();
+        case VertexFormat::Quantized: return of<QuantizedVertex>();
+        default:                      return of<Vertex>();
+        }
+    }
+
+    /// バインド中の VAO に、バインド中の GL_ARRAY_BUFFER を layout の属性として登録する
+    void apply(const VertexLayoutView& layout);
+}
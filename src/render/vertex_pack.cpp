@@ -0,0 +1,213 @@
+#include "render/vertex_pack.h"
+
+#include "algorithm"
+#include "cmath"
+#include "cstring"
+#include "stdexcept"
+
+namespace
+{
+    uint32_t toUnorm8(float v)
+    {
+        return (uint32_t)std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f);
+    }
+
+    uint32_t toSnorm16(float v)
+    {
+        return (uint32_t)(uint16_t)(int16_t)std::lround(std::clamp(v, -1.0f, 1.0f) * 32767.0f);
+    }
+
+    float fromSnorm16(uint32_t v)
+    {
+        return std::max((float)(int16_t)(uint16_t)v / 32767.0f, -1.0f);
+    }
+
+    float signNotZero(float v)
+    {
+        return v >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    void checkAttributes(size_t count, std::span<const glm::vec3> normals, std::span<const glm::vec2> texcoords)
+    {
+        if ((!normals.empty() && normals.size() != count) || (!texcoords.empty() && texcoords.size() != count))
+            throw std::runtime_error("vertex_pack: normals / texcoords must match the vertex count");
+    }
+}
+
+uint32_t vertex_pack::packColor(const glm::vec4& c)
+{
+    return toUnorm8(c.x) | (toUnorm8(c.y) << 8) | (toUnorm8(c.z) << 16) | (toUnorm8(c.w) << 24);
+}
+
+glm::vec4 vertex_pack::unpackColor(uint32_t c)
+{
+    return glm::vec4(
+        (float)(c & 0xFF) / 255.0f,
+        (float)((c >> 8) & 0xFF) / 255.0f,
+        (float)((c >> 16) & 0xFF) / 255.0f,
+        (float)(c >> 24) / 255.0f);
+}
+
+uint32_t vertex_pack::packNormal(const glm::vec3& n)
+{
+    // 正八面体へ射影し、下半分は対角線で折り返して [-1, 1]^2 に収める
+    const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1 <= 0.0f) return toSnorm16(0.0f) | (toSnorm16(0.0f) << 16);   // 未定義は +Z
+
+    float x = n.x / l1;
+    float y = n.y / l1;
+    if (n.z < 0.0f)
+    {
+        const float ox = x;
+        x = (1.0f - std::abs(y)) * signNotZero(ox);
+        y = (1.0f - std::abs(ox)) * signNotZero(y);
+    }
+    return toSnorm16(x) | (toSnorm16(y) << 16);
+}
+
+glm::vec3 vertex_pack::unpackNormal(uint32_t packed)
+{
+    const float x = fromSnorm16(packed & 0xFFFF);
+    const float y = fromSnorm16(packed >> 16);
+
+    glm::vec3 n(x, y, 1.0f - std::abs(x) - std::abs(y));
+    const float t = std::max(-n.z, 0.0f);
+    n.x += (n.x >= 0.0f) ? -t : t;
+    n.y += (n.y >= 0.0f) ? -t : t;
+    return glm::normalize(n);
+}
+
+uint16_t vertex_pack::floatToHalf(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const int32_t  exp = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mant = bits & 0x7FFFFFu;
+
+    if (((bits >> 23) & 0xFF) == 0xFF)                  // Inf / NaN
+        return (uint16_t)(sign | 0x7C00u | (mant ? 0x200u : 0u));
+    if (exp >= 31)                                      // 範囲外は Inf
+        return (uint16_t)(sign | 0x7C00u);
+    if (exp <= 0)
+    {
+        // 非正規化数（小さすぎれば 0）
+        if (exp < -10) return (uint16_t)sign;
+        mant |= 0x800000u;
+        const uint32_t shift = (uint32_t)(14 - exp);
+        uint32_t half = mant >> shift;
+        const uint32_t rest = mant & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) ++half;   // 最近接偶数丸め
+        return (uint16_t)(sign | half);
+    }
+
+    uint32_t half = sign | ((uint32_t)exp << 10) | (mant >> 13);
+    const uint32_t rest = mant & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) ++half;       // 繰り上がりは指数へ
+    return (uint16_t)half;
+}
+
+float vertex_pack::halfToFloat(uint16_t h)
+{
+    const uint32_t sign = (uint32_t)(h & 0x8000u) << 16;
+    const uint32_t exp = (h >> 10) & 0x1Fu;
+    const uint32_t mant = h & 0x3FFu;
+
+    uint32_t bits;
+    if (exp == 0)
+    {
+        if (mant == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            // 非正規化数を正規化し直す
+            int e = -1;
+            uint32_t m = mant;
+            do { ++e; m <<= 1; } while ((m & 0x400u) == 0);
+            bits = sign | ((uint32_t)(127 - 15 - e) << 23) | ((m & 0x3FFu) << 13);
+        }
+    }
+    else if (exp == 31)
+    {
+        bits = sign | 0x7F800000u | (mant << 13);
+    }
+    else
+    {
+        bits = sign | ((exp - 15 + 127) << 23) | (mant << 13);
+    }
+
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+uint32_t vertex_pack::packUv(const glm::vec2& uv)
+{
+    return (uint32_t)floatToHalf(uv.x) | ((uint32_t)floatToHalf(uv.y) << 16);
+}
+
+glm::vec2 vertex_pack::unpackUv(uint32_t uv)
+{
+    return glm::vec2(halfToFloat((uint16_t)(uv & 0xFFFF)), halfToFloat((uint16_t)(uv >> 16)));
+}
+
+void vertex_pack::pack(std::span<const Vertex> verts,
+    std::span<const glm::vec3> normals, std::span<const glm::vec2> texcoords,
+    std::vector<PackedVertex>& out)
+{
+    checkAttributes(verts.size(), normals, texcoords);
+
+    out.resize(verts.size());
+    for (size_t i = 0; i < verts.size(); ++i)
+    {
+        PackedVertex& v = out[i];
+        v.position = verts[i].position;
+        v.color = packColor(verts[i].color);
+        v.normal = packNormal(normals.empty() ? glm::vec3(0.0f, 0.0f, 1.0f) : normals[i]);
+        v.uv = texcoords.empty() ? 0u : packUv(texcoords[i]);
+    }
+}
+
+vertex_pack::Dequantize vertex_pack::quantize(std::span<const Vertex> verts,
+    std::span<const glm::vec3> normals, std::span<const glm::vec2> texcoords,
+    std::vector<QuantizedVertex>& out)
+{
+    checkAttributes(verts.size(), normals, texcoords);
+
+    Dequantize dq;
+    out.resize(verts.size());
+    if (verts.empty()) return dq;
+
+    glm::vec3 bmin = verts[0].position, bmax = verts[0].position;
+    for (const Vertex& v : verts)
+    {
+        bmin = glm::min(bmin, v.position);
+        bmax = glm::max(bmax, v.position);
+    }
+
+    // 厚みの無い軸は 0 除算しないよう 1 にしておく（全頂点がその軸で bias に戻る）
+    const glm::vec3 extent = bmax - bmin;
+    dq.bias = bmin;
+    dq.scale = glm::vec3(
+        extent.x > 0.0f ? extent.x : 1.0f,
+        extent.y > 0.0f ? extent.y : 1.0f,
+        extent.z > 0.0f ? extent.z : 1.0f);
+    const glm::vec3 toUnit = 1.0f / dq.scale;
+
+    for (size_t i = 0; i < verts.size(); ++i)
+    {
+        QuantizedVertex& v = out[i];
+        const glm::vec3 t = (verts[i].position - dq.bias) * toUnit;
+        for (int a = 0; a < 3; ++a)
+            v.position[a] = (uint16_t)std::lround(std::clamp(t[a], 0.0f, 1.0f) * 65535.0f);
+        v.pad = 0;
+        v.color = packColor(verts[i].color);
+        v.normal = packNormal(normals.empty() ? glm::vec3(0.0f, 0.0f, 1.0f) : normals[i]);
+        v.uv = texcoords.empty() ? 0u : packUv(texcoords[i]);
+    }
+    return dq;
+}
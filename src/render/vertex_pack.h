@@ -0,0 +1,52 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+#include "vector"
+
+#include "glm/glm.hpp"
+
+#include "render/vertex.h"
+
+/**
+ * @brief 頂点属性の圧縮・展開（GL 非依存）
+ *
+ * 展開はシェーダ側（line.glsl / pick.glsl）と同じ式。
+ * unpack 系は検証・CPU 側での読み戻し用。
+ */
+namespace vertex_pack
+{
+    /// RGBA8（R が下位バイト。GL_UNSIGNED_BYTE × 4 の正規化属性として読める）
+    uint32_t packColor(const glm::vec4& c);
+    glm::vec4 unpackColor(uint32_t c);
+
+    /// 八面体符号化（x が下位 16 ビット、GL_SHORT × 2 の正規化属性として読める）
+    uint32_t packNormal(const glm::vec3& n);
+    glm::vec3 unpackNormal(uint32_t n);
+
+    uint16_t floatToHalf(float f);
+    float halfToFloat(uint16_t h);
+    uint32_t packUv(const glm::vec2& uv);
+    glm::vec2 unpackUv(uint32_t uv);
+
+    /// 量子化位置の復元係数（position = q / 65535 * scale + bias）
+    struct Dequantize
+    {
+        glm::vec3 scale{ 1.0f };
+        glm::vec3 bias{ 0.0f };
+    };
+
+    /**
+     * @brief Vertex 列（と頂点ごとの法線・UV）を圧縮形式へ変換する
+     *
+     * normals / texcoords は verts と同じ長さか空。空なら法線 +Z、UV 0 で埋める。
+     */
+    void pack(std::span<const Vertex> verts,
+        std::span<const glm::vec3> normals, std::span<const glm::vec2> texcoords,
+        std::vector<PackedVertex>& out);
+
+    /// 位置を AABB 基準で量子化する。@return シェーダに渡す復元係数
+    Dequantize quantize(std::span<const Vertex> verts,
+        std::span<const glm::vec3> normals, std::span<const glm::vec2> texcoords,
+        std::vector<QuantizedVertex>& out);
+}
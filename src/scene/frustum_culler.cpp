@@ -0,0 +1,198 @@
+#include "scene/frustum_culler.h"
+
+#include "algorithm"
+#include "bit"
+#include "cmath"
+#include "thread"
+#include "vector"
+
+#if defined(__AVX__)
+#include "immintrin.h"
+#define AQUA_CULL_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include "emmintrin.h"
+#define AQUA_CULL_SSE 1
+#endif
+
+namespace
+{
+    // 平面ごとに (nx, ny, nz, d, |nx|, |ny|, |nz|) を並べておく
+    struct PlaneSet
+    {
+        float n[6][7];
+    };
+
+    PlaneSet makePlaneSet(const Frustum& f)
+    {
+        PlaneSet s{};
+        for (int p = 0; p < 6; ++p)
+        {
+            const glm::vec4& pl = f.planes[p];
+            s.n[p][0] = pl.x; s.n[p][1] = pl.y; s.n[p][2] = pl.z; s.n[p][3] = pl.w;
+            s.n[p][4] = std::abs(pl.x); s.n[p][5] = std::abs(pl.y); s.n[p][6] = std::abs(pl.z);
+        }
+        return s;
+    }
+
+    uint32_t cullScalar(const PlaneSet& ps, const Scene::BoundsSoA& b, uint8_t* out, size_t begin, size_t end)
+    {
+        uint32_t count = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            bool inside = true;
+            for (int p = 0; p < 6 && inside; ++p)
+            {
+                const float* n = ps.n[p];
+                const float d = n[0] * b.cx[i] + n[1] * b.cy[i] + n[2] * b.cz[i] + n[3];
+                const float r = n[4] * b.ex[i] + n[5] * b.ey[i] + n[6] * b.ez[i];
+                inside = (d + r >= 0.0f);
+            }
+            out[i] = inside ? 1 : 0;
+            count += inside ? 1 : 0;
+        }
+        return count;
+    }
+
+    uint32_t cullRange(const PlaneSet& ps, const Scene::BoundsSoA& b, uint8_t* out, size_t begin, size_t end)
+    {
+        size_t i = begin;
+        uint32_t count = 0;
+
+#if AQUA_CULL_AVX
+        const __m256 zero = _mm256_setzero_ps();
+        for (; i + 8 <= end; i += 8)
+        {
+            const __m256 cx = _mm256_loadu_ps(b.cx.data() + i);
+            const __m256 cy = _mm256_loadu_ps(b.cy.data() + i);
+            const __m256 cz = _mm256_loadu_ps(b.cz.data() + i);
+            const __m256 ex = _mm256_loadu_ps(b.ex.data() + i);
+            const __m256 ey = _mm256_loadu_ps(b.ey.data() + i);
+            const __m256 ez = _mm256_loadu_ps(b.ez.data() + i);
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int p = 0; p < 6; ++p)
+            {
+                // 加算を木にして依存の連鎖を短くする
+                const float* n = ps.n[p];
+                const __m256 d0 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(n[0]), cx), _mm256_mul_ps(_mm256_set1_ps(n[1]), cy));
+                const __m256 d1 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(n[2]), cz), _mm256_set1_ps(n[3]));
+                const __m256 r0 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(n[4]), ex), _mm256_mul_ps(_mm256_set1_ps(n[5]), ey));
+                const __m256 r1 = _mm256_mul_ps(_mm256_set1_ps(n[6]), ez);
+                const __m256 d = _mm256_add_ps(_mm256_add_ps(d0, d1), _mm256_add_ps(r0, r1));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, zero, _CMP_GE_OQ));
+
+                // 全部外に出たら残りの平面は見ない（画面外の物体はたいてい最初の数平面で落ちる）
+                if (_mm256_movemask_ps(inside) == 0) break;
+            }
+
+            const int mask = _mm256_movemask_ps(inside);
+            for (int k = 0; k < 8; ++k)
+                out[i + k] = (uint8_t)((mask >> k) & 1);
+            count += (uint32_t)std::popcount((unsigned)mask);
+        }
+#elif AQUA_CULL_SSE
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 cx = _mm_loadu_ps(b.cx.data() + i);
+            const __m128 cy = _mm_loadu_ps(b.cy.data() + i);
+            const __m128 cz = _mm_loadu_ps(b.cz.data() + i);
+            const __m128 ex = _mm_loadu_ps(b.ex.data() + i);
+            const __m128 ey = _mm_loadu_ps(b.ey.data() + i);
+            const __m128 ez = _mm_loadu_ps(b.ez.data() + i);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < 6; ++p)
+            {
+                // 加算を木にして依存の連鎖を短くする
+                const float* n = ps.n[p];
+                const __m128 d0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[0]), cx), _mm_mul_ps(_mm_set1_ps(n[1]), cy));
+                const __m128 d1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[2]), cz), _mm_set1_ps(n[3]));
+                const __m128 r0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(n[4]), ex), _mm_mul_ps(_mm_set1_ps(n[5]), ey));
+                const __m128 r1 = _mm_mul_ps(_mm_set1_ps(n[6]), ez);
+                const __m128 d = _mm_add_ps(_mm_add_ps(d0, d1), _mm_add_ps(r0, r1));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+
+                // 全部外に出たら残りの平面は見ない（画面外の物体はたいてい最初の数平面で落ちる）
+                if (_mm_movemask_ps(inside) == 0) break;
+            }
+
+            const int mask = _mm_movemask_ps(inside);
+            out[i + 0] = (uint8_t)(mask & 1);
+            out[i + 1] = (uint8_t)((mask >> 1) & 1);
+            out[i + 2] = (uint8_t)((mask >> 2) & 1);
+            out[i + 3] = (uint8_t)((mask >> 3) & 1);
+            count += (uint32_t)std::popcount((unsigned)mask);
+        }
+#endif
+
+        return count + cullScalar(ps, b, out, i, end);
+    }
+}
+
+Frustum Frustum::fromViewProj(const glm::mat4& vp)
+{
+    // glm は列優先なので行 i = (m[0][i], m[1][i], m[2][i], m[3][i])
+    auto row = [&](int i) { return glm::vec4(vp[0][i], vp[1][i], vp[2][i], vp[3][i]); };
+    const glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+    Frustum f;
+    f.planes[0] = r3 + r0;  // left
+    f.planes[1] = r3 - r0;  // right
+    f.planes[2] = r3 + r1;  // bottom
+    f.planes[3] = r3 - r1;  // top
+    f.planes[4] = r3 + r2;  // near
+    f.planes[5] = r3 - r2;  // far
+
+    for (glm::vec4& p : f.planes)
+    {
+        const float len = glm::length(glm::vec3(p));
+        if (len > 0.0f) p = p / len;
+    }
+    return f;
+}
+
+bool Frustum::intersects(const glm::vec3& c, const glm::vec3& e) const
+{
+    for (const glm::vec4& p : planes)
+    {
+        const glm::vec3 n(p);
+        if (glm::dot(n, c) + p.w + glm::dot(glm::abs(n), e) < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+uint32_t frustum_cull::cull(const Frustum& frustum, const Scene::BoundsSoA& bounds,
+    std::span<uint8_t> visible, unsigned threadCount)
+{
+    const size_t n = std::min(bounds.size(), visible.size());
+    const PlaneSet ps = makePlaneSet(frustum);
+
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    if (n < kParallelThreshold || threadCount == 1)
+        return cullRange(ps, bounds, visible.data(), 0, n);
+
+    // 8 の倍数で区切って SIMD の端数をスレッド境界に作らない
+    const size_t chunks = std::min<size_t>(threadCount, n / (kParallelThreshold / 4));
+    const size_t per = ((n + chunks - 1) / chunks + 7) & ~size_t(7);
+
+    std::vector<uint32_t> counts(chunks, 0);
+    std::vector<std::thread> threads;
+    threads.reserve(chunks - 1);
+    for (size_t c = 1; c < chunks; ++c)
+    {
+        threads.emplace_back([&, c]
+            {
+                const size_t b = std::min(n, c * per);
+                const size_t e = std::min(n, b + per);
+                counts[c] = cullRange(ps, bounds, visible.data(), b, e);
+            });
+    }
+    counts[0] = cullRange(ps, bounds, visible.data(), 0, std::min(n, per));
+    for (std::thread& t : threads) t.join();
+
+    uint32_t total = 0;
+    for (uint32_t c : counts) total += c;
+    return total;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+
+#include "glm/glm.hpp"
+
+#include "scene/scene.h"
+
+/**
+ * @brief 視錐台（6 平面、法線は内向き・正規化済み）
+ */
+struct Frustum
+{
+    glm::vec4 planes[6];    ///< (n, d)：dot(n, p) + d >= 0 が内側
+
+    /**
+     * @brief VP 行列から平面を取り出す（Gribb / Hartmann）
+     *
+     * OpenGL のクリップ空間（-w <= z <= w）を前提にする。
+     */
+    static Frustum fromViewProj(const glm::mat4& vp);
+
+    /// 中心 c・半径 e の AABB が視錐台と交わる（または内側）なら true
+    bool intersects(const glm::vec3& c, const glm::vec3& e) const;
+};
+
+/**
+ * @brief AABB の視錐台カリング
+ *
+ * Scene::worldBounds() の SoA をそのまま読み、AVX なら 8 個、SSE なら 4 個ずつ
+ * 6 平面と判定する（平面ごとに dot(n, c) + d + dot(|n|, e) >= 0）。
+ * 判定は保守的で、平面の外側に完全に出ている箱だけを捨てる。
+ *
+ * 個数が kParallelThreshold 以上なら範囲を分けて複数スレッドで処理する。
+ */
+namespace frustum_cull
+{
+    constexpr size_t kParallelThreshold = 1u << 16;
+
+    /**
+     * @param visible 出力。bounds.size() 個、見えるなら 1
+     * @return 見えている個数
+     */
+    uint32_t cull(const Frustum& frustum, const Scene::BoundsSoA& bounds,
+        std::span<uint8_t> visible, unsigned threadCount = 0);
+}
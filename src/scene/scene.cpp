@@ -0,0 +1,145 @@
+#include "scene/scene.h"
+
+#include "algorithm"
+#include "cmath"
+#include "stdexcept"
+
+Scene::Scene() = default;
+
+void Scene::clear()
+{
+    m_parent.clear();
+    m_mesh.clear();
+    m_color.clear();
+
+    m_translation.clear();
+    m_rotation.clear();
+    m_scale.clear();
+
+    m_boundsCenter.clear();
+    m_boundsExtent.clear();
+
+    m_world.clear();
+    for (std::vector<float>* v : { &m_worldCx, &m_worldCy, &m_worldCz, &m_worldEx, &m_worldEy, &m_worldEz })
+        v->clear();
+    m_dirty.clear();
+
+    m_firstDirty = kNoParent;
+    m_lastUpdated = 0;
+    ++m_revision;
+}
+
+void Scene::reserve(size_t nodeCount)
+{
+    m_parent.reserve(nodeCount);
+    m_mesh.reserve(nodeCount);
+    m_color.reserve(nodeCount);
+
+    m_translation.reserve(nodeCount);
+    m_rotation.reserve(nodeCount);
+    m_scale.reserve(nodeCount);
+
+    m_boundsCenter.reserve(nodeCount);
+    m_boundsExtent.reserve(nodeCount);
+
+    m_world.reserve(nodeCount);
+    for (std::vector<float>* v : { &m_worldCx, &m_worldCy, &m_worldCz, &m_worldEx, &m_worldEy, &m_worldEz })
+        v->reserve(nodeCount);
+    m_dirty.reserve(nodeCount);
+}
+
+uint32_t Scene::addNode(uint32_t parent, uint32_t mesh)
+{
+    const uint32_t n = nodeCount();
+    if (parent != kNoParent && parent >= n)
+        throw std::runtime_error("Scene::addNode parent must be an existing node");
+
+    m_parent.push_back(parent);
+    m_mesh.push_back(mesh);
+    m_color.push_back(glm::vec4(1.0f));
+
+    m_translation.push_back(glm::vec3(0.0f));
+    m_rotation.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    m_scale.push_back(glm::vec3(1.0f));
+
+    m_boundsCenter.push_back(glm::vec3(0.0f));
+    m_boundsExtent.push_back(glm::vec3(-1.0f));
+
+    m_world.push_back(glm::mat4(1.0f));
+    m_worldCx.push_back(0.0f); m_worldCy.push_back(0.0f); m_worldCz.push_back(0.0f);
+    m_worldEx.push_back(kUnbounded); m_worldEy.push_back(kUnbounded); m_worldEz.push_back(kUnbounded);
+    m_dirty.push_back(0);
+    markDirty(n);
+    return n;
+}
+
+void Scene::setLocalBounds(uint32_t n, const glm::vec3& min, const glm::vec3& max)
+{
+    m_boundsCenter[n] = (min + max) * 0.5f;
+    m_boundsExtent[n] = glm::max((max - min) * 0.5f, glm::vec3(0.0f));
+    markDirty(n);
+}
+
+void Scene::setUnbounded(uint32_t n)
+{
+    m_boundsCenter[n] = glm::vec3(0.0f);
+    m_boundsExtent[n] = glm::vec3(-1.0f);
+    markDirty(n);
+}
+
+Scene::BoundsSoA Scene::worldBounds() const
+{
+    return { m_worldCx, m_worldCy, m_worldCz, m_worldEx, m_worldEy, m_worldEz };
+}
+
+uint32_t Scene::updateWorld()
+{
+    m_lastUpdated = 0;
+    if (m_firstDirty == kNoParent) return 0;
+
+    const uint32_t count = nodeCount();
+    uint32_t updated = 0;
+
+    // 親は必ず前にあるので、親の dirty は子を見る時点で確定している
+    for (uint32_t n = m_firstDirty; n < count; ++n)
+    {
+        const uint32_t p = m_parent[n];
+        if (p != kNoParent && m_dirty[p]) m_dirty[n] = 1;
+        if (!m_dirty[n]) continue;
+
+        // T * R * S を列ごとに直接組み立てる
+        const glm::mat3 r = glm::mat3_cast(m_rotation[n]);
+        const glm::vec3& s = m_scale[n];
+        const glm::mat4 local(
+            glm::vec4(r[0] * s.x, 0.0f),
+            glm::vec4(r[1] * s.y, 0.0f),
+            glm::vec4(r[2] * s.z, 0.0f),
+            glm::vec4(m_translation[n], 1.0f));
+
+        const glm::mat4& w = m_world[n] = (p != kNoParent) ? m_world[p] * local : local;
+
+        // ワールド AABB：中心は変換、半径は |M| で広げる（Arvo の方法）
+        const glm::vec3& e = m_boundsExtent[n];
+        if (e.x < 0.0f)
+        {
+            m_worldCx[n] = m_worldCy[n] = m_worldCz[n] = 0.0f;
+            m_worldEx[n] = m_worldEy[n] = m_worldEz[n] = kUnbounded;
+        }
+        else
+        {
+            const glm::vec4 c = w * glm::vec4(m_boundsCenter[n], 1.0f);
+            m_worldCx[n] = c.x;
+            m_worldCy[n] = c.y;
+            m_worldCz[n] = c.z;
+            m_worldEx[n] = std::abs(w[0].x) * e.x + std::abs(w[1].x) * e.y + std::abs(w[2].x) * e.z;
+            m_worldEy[n] = std::abs(w[0].y) * e.x + std::abs(w[1].y) * e.y + std::abs(w[2].y) * e.z;
+            m_worldEz[n] = std::abs(w[0].z) * e.x + std::abs(w[1].z) * e.y + std::abs(w[2].z) * e.z;
+        }
+        ++updated;
+    }
+
+    std::fill(m_dirty.begin() + m_firstDirty, m_dirty.end(), uint8_t(0));
+    m_firstDirty = kNoParent;
+    m_lastUpdated = updated;
+    return updated;
+}
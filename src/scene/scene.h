@@ -0,0 +1,140 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+#include "vector"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+/**
+ * @brief フラットな SoA 配列によるシーン（トランスフォーム階層）
+ *
+ * ノードは親・ローカル TRS・ワールド行列・描画メッシュを
+ * それぞれ独立した配列で持つ。インデックスはすべて uint32_t。
+ *
+ * - ノードは親より後ろにしか追加できないため、配列は常にトポロジカル順
+ *   （parent(i) < i）。ワールド行列の更新は先頭から 1 回の線形走査で済む
+ * - TRS を変更したノードだけ dirty にし、updateWorld() で
+ *   dirty なノードとその子孫だけ行列を計算し直す
+ * - 走査は最も若い dirty ノードから始めるので、何も変えなければ O(1)
+ *
+ * mesh は描画側（Renderer）のメッシュ番号。kNoMesh なら描画しない。
+ * color はインスタンス色（頂点色に乗算される）。
+ * ローカル AABB を与えたノードは、ワールド行列と同じ走査でワールド AABB
+ * （中心・半径の SoA）も更新する。既定は無限大（カリングされない）。
+ * 描画側は revision() の変化を見てインスタンスデータを作り直す。
+ * GL には依存しない。
+ */
+class Scene
+{
+public:
+    static constexpr uint32_t kNoParent = 0xFFFFFFFFu;
+    static constexpr uint32_t kNoMesh = 0xFFFFFFFFu;
+
+    /// 範囲を持たないノードのワールド半径（平面との内積が 0 でも NaN にならない有限値）
+    static constexpr float kUnbounded = 1e30f;
+
+    /// ワールド AABB（中心 c と半径 e）の SoA。カリングはこの配列をそのまま読む
+    struct BoundsSoA
+    {
+        std::span<const float> cx, cy, cz;
+        std::span<const float> ex, ey, ez;
+
+        size_t size() const { return cx.size(); }
+    };
+
+    Scene();
+
+    // ===== Build =====
+
+    void clear();
+    void reserve(size_t nodeCount);
+
+    /**
+     * @brief ノードを追加する（TRS は単位）
+     *
+     * @param parent 既存ノード、または kNoParent
+     * @return 追加したノードのインデックス
+     */
+    uint32_t addNode(uint32_t parent = kNoParent, uint32_t mesh = kNoMesh);
+
+    // ===== Access =====
+
+    uint32_t nodeCount() const { return (uint32_t)m_parent.size(); }
+
+    uint32_t parent(uint32_t n) const { return m_parent[n]; }
+    uint32_t mesh(uint32_t n) const { return m_mesh[n]; }
+    void setMesh(uint32_t n, uint32_t mesh) { m_mesh[n] = mesh; ++m_revision; }
+
+    const glm::vec4& color(uint32_t n) const { return m_color[n]; }
+    void setColor(uint32_t n, const glm::vec4& c) { m_color[n] = c; ++m_revision; }
+
+    const glm::vec3& translation(uint32_t n) const { return m_translation[n]; }
+    const glm::quat& rotation(uint32_t n) const { return m_rotation[n]; }
+    const glm::vec3& scale(uint32_t n) const { return m_scale[n]; }
+
+    void setTranslation(uint32_t n, const glm::vec3& t) { m_translation[n] = t; markDirty(n); }
+    void setRotation(uint32_t n, const glm::quat& r) { m_rotation[n] = r; markDirty(n); }
+    void setScale(uint32_t n, const glm::vec3& s) { m_scale[n] = s; markDirty(n); }
+
+    /// ローカル空間の AABB（メッシュの範囲）
+    void setLocalBounds(uint32_t n, const glm::vec3& min, const glm::vec3& max);
+    void setUnbounded(uint32_t n);
+
+    /// updateWorld() 後に有効
+    const glm::mat4& world(uint32_t n) const { return m_world[n]; }
+    BoundsSoA worldBounds() const;
+
+    // ===== Update =====
+
+    /**
+     * @brief dirty なノードとその子孫のワールド行列を更新する
+     *
+     * @return 計算し直したノード数
+     */
+    uint32_t updateWorld();
+
+    uint32_t lastUpdatedCount() const { return m_lastUpdated; }
+
+    /// ノード構成・メッシュ・色・TRS のいずれかが変わるたびに増える
+    uint64_t revision() const { return m_revision; }
+
+    // ===== Raw SoA arrays =====
+
+    std::span<const uint32_t>  parents() const { return m_parent; }
+    std::span<const uint32_t>  meshes() const { return m_mesh; }
+    std::span<const glm::vec4> colors() const { return m_color; }
+    std::span<const glm::mat4> worlds() const { return m_world; }
+
+private:
+    std::vector<uint32_t>  m_parent;
+    std::vector<uint32_t>  m_mesh;
+    std::vector<glm::vec4> m_color;
+
+    // --- Local TRS ---
+    std::vector<glm::vec3> m_translation;
+    std::vector<glm::quat> m_rotation;
+    std::vector<glm::vec3> m_scale;
+
+    // --- Local bounds（extent.x < 0 なら無限大）---
+    std::vector<glm::vec3> m_boundsCenter;
+    std::vector<glm::vec3> m_boundsExtent;
+
+    // --- World ---
+    std::vector<glm::mat4> m_world;
+    std::vector<float> m_worldCx, m_worldCy, m_worldCz;
+    std::vector<float> m_worldEx, m_worldEy, m_worldEz;
+    std::vector<uint8_t>   m_dirty;       ///< 1 = 自身の TRS が変わった、または親が更新された
+
+    uint32_t m_firstDirty = kNoParent;    ///< 最も若い dirty ノード（無ければ kNoParent）
+    uint32_t m_lastUpdated = 0;
+    uint64_t m_revision = 0;
+
+    void markDirty(uint32_t n)
+    {
+        ++m_revision;
+        m_dirty[n] = 1;
+        if (m_firstDirty == kNoParent || n < m_firstDirty) m_firstDirty = n;
+    }
+};
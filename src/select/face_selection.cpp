@@ -0,0 +1,27 @@
+#include "select/face_selection.h"
+
+#include "algorithm"
+
+void FaceSelection::set(std::span<const uint32_t> sortedIds)
+{
+    m_ids.assign(sortedIds.begin(), sortedIds.end());
+}
+
+void FaceSelection::add(uint32_t id)
+{
+    auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    if (it == m_ids.end() || *it != id)
+        m_ids.insert(it, id);
+}
+
+void FaceSelection::remove(uint32_t id)
+{
+    auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    if (it != m_ids.end() && *it == id)
+        m_ids.erase(it);
+}
+
+bool FaceSelection::contains(uint32_t id) const
+{
+    return std::binary_search(m_ids.begin(), m_ids.end(), id);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+#include "vector"
+
+// 選択中の面 ID（face + 1）の集合。昇順・重複なしで保持する
+class FaceSelection
+{
+public:
+    void clear() { m_ids.clear(); }
+    void set(std::span<const uint32_t> sortedIds);
+    void add(uint32_t id);
+    void remove(uint32_t id);
+    bool contains(uint32_t id) const;
+
+    bool empty() const { return m_ids.empty(); }
+    size_t size() const { return m_ids.size(); }
+    const std::vector<uint32_t>& ids() const { return m_ids; }
+
+private:
+    std::vector<uint32_t> m_ids;
+};
@@ -0,0 +1,113 @@
+#include "select/id_reduce.h"
+
+#include "algorithm"
+#include "bit"
+#include "cmath"
+#include "cstring"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include "emmintrin.h"
+#define AQUA_ID_REDUCE_SSE2 1
+#endif
+
+void id_reduce::collectUniqueIds(std::span<const uint32_t> ids, uint32_t maxId, std::vector<uint32_t>& out)
+{
+    out.clear();
+
+    const size_t words = (size_t)maxId / 64 + 1;
+    std::vector<uint64_t> bits(words, 0);
+
+    const uint32_t* p = ids.data();
+    const size_t n = ids.size();
+    size_t i = 0;
+
+    // 範囲外の ID は背景（0）扱いにして分岐なしで立てる
+    auto mark = [&](uint32_t id)
+        {
+            id = (id <= maxId) ? id : 0u;
+            bits[id >> 6] |= 1ull << (id & 63);
+        };
+
+#if AQUA_ID_REDUCE_SSE2
+    __m128i vlast = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i*)(p + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(p + i + 4));
+
+        // 8 ピクセルすべて直前と同じ ID（背景の連続を含む）なら読み飛ばす
+        const __m128i eq = _mm_and_si128(_mm_cmpeq_epi32(a, vlast), _mm_cmpeq_epi32(b, vlast));
+        if (_mm_movemask_epi8(eq) != 0xFFFF)
+        {
+            // 1 つ左隣のピクセルと比べ、値が変わったレーンだけ立てる
+            const __m128i prevA = _mm_or_si128(_mm_slli_si128(a, 4), _mm_srli_si128(vlast, 12));
+            const __m128i prevB = _mm_or_si128(_mm_slli_si128(b, 4), _mm_srli_si128(a, 12));
+            const int changed =
+                (~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, prevA))) & 0xF) |
+                ((~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(b, prevB))) & 0xF) << 4);
+
+            for (unsigned m = (unsigned)changed; m; m &= m - 1)
+                mark(p[i + std::countr_zero(m)]);
+
+            vlast = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+    }
+#endif
+    for (; i < n; ++i)
+        mark(p[i]);
+
+    // 0 は背景
+    bits[0] &= ~1ull;
+
+    for (size_t w = 0; w < words; ++w)
+    {
+        uint64_t m = bits[w];
+        while (m)
+        {
+            out.push_back((uint32_t)(w * 64 + std::countr_zero(m)));
+            m &= m - 1;
+        }
+    }
+}
+
+void id_reduce::maskOutsidePolygon(std::span<uint32_t> ids, int w, int h, std::span<const glm::vec2> poly)
+{
+    if (poly.size() < 3)
+    {
+        std::fill(ids.begin(), ids.end(), 0u);
+        return;
+    }
+
+    std::vector<float> xs;
+    xs.reserve(poly.size());
+
+    for (int y = 0; y < h; ++y)
+    {
+        const float sy = (float)y + 0.5f;
+
+        // この行と交差する辺の x 座標
+        xs.clear();
+        for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++)
+        {
+            const glm::vec2& a = poly[i];
+            const glm::vec2& b = poly[j];
+            if ((a.y <= sy) == (b.y <= sy)) continue;
+            xs.push_back(a.x + (sy - a.y) * (b.x - a.x) / (b.y - a.y));
+        }
+        std::sort(xs.begin(), xs.end());
+
+        uint32_t* row = ids.data() + (size_t)y * w;
+
+        // [cursor, 次の内側区間の始点) を 0 で埋める
+        int cursor = 0;
+        for (size_t k = 0; k + 1 < xs.size(); k += 2)
+        {
+            // ピクセル中心 x + 0.5 が [x0, x1) に入る範囲
+            const int x0 = std::clamp((int)std::ceil(xs[k] - 0.5f), 0, w);
+            const int x1 = std::clamp((int)std::ceil(xs[k + 1] - 0.5f), 0, w);
+            if (x0 > cursor) std::memset(row + cursor, 0, (size_t)(x0 - cursor) * sizeof(uint32_t));
+            cursor = std::max(cursor, x1);
+        }
+        if (cursor < w) std::memset(row + cursor, 0, (size_t)(w - cursor) * sizeof(uint32_t));
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+#include "vector"
+
+#include "glm/glm.hpp"
+
+// ID バッファ（GL_R32UI）の読み出し結果を ID 集合に縮約する
+namespace id_reduce
+{
+    /**
+     * @brief ID 列から重複なしの ID 集合を作る
+     *
+     * @param ids   読み出したピクセル列（0 は背景）
+     * @param maxId 取り得る最大 ID（これを超える値は無視）
+     * @param out   昇順の ID（0 は含まない）
+     *
+     * ID バッファは同じ値が連続しやすいので、
+     * 8 ピクセル単位で「直前の ID と全部同じか」を SIMD で判定して読み飛ばし、
+     * 値が変わったピクセルだけビットセットに立てる。
+     */
+    void collectUniqueIds(std::span<const uint32_t> ids, uint32_t maxId, std::vector<uint32_t>& out);
+
+    /**
+     * @brief 多角形の外側のピクセルを 0（背景）で塗りつぶす
+     *
+     * @param ids  w * h のピクセル列（行優先）
+     * @param poly ピクセル座標の多角形（ピクセル (x, y) の中心は (x + 0.5, y + 0.5)）
+     *
+     * 偶奇規則のスキャンライン。行ごとに辺との交点を求めて内側区間だけ残す。
+     */
+    void maskOutsidePolygon(std::span<uint32_t> ids, int w, int h, std::span<const glm::vec2> poly);
+}
@@ -0,0 +1,114 @@
+#include "select/region_faces.h"
+
+#include "algorithm"
+
+namespace
+{
+    // クリップ空間の視錐台（dot(plane, p) >= 0 が内側）。GL の z は [-w, w]
+    const glm::vec4 kFrustumPlanes[6] = {
+        { 1.0f, 0.0f, 0.0f, 1.0f }, { -1.0f, 0.0f, 0.0f, 1.0f },
+        { 0.0f, 1.0f, 0.0f, 1.0f }, { 0.0f, -1.0f, 0.0f, 1.0f },
+        { 0.0f, 0.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, -1.0f, 1.0f },
+    };
+
+    /// 多角形を平面の内側へ切り詰める（Sutherland–Hodgman）
+    void clipPlane(const std::vector<glm::vec4>& in, const glm::vec4& plane, std::vector<glm::vec4>& out)
+    {
+        out.clear();
+        const size_t n = in.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            const glm::vec4& a = in[i];
+            const glm::vec4& b = in[(i + 1) % n];
+            const float da = glm::dot(plane, a);
+            const float db = glm::dot(plane, b);
+            if (da >= 0.0f) out.push_back(a);
+            if ((da >= 0.0f) != (db >= 0.0f)) out.push_back(a + (b - a) * (da / (da - db)));
+        }
+    }
+
+    float cross(const glm::vec2& a, const glm::vec2& b)
+    {
+        return a.x * b.y - a.y * b.x;
+    }
+
+    /// 偶奇規則（id_reduce::maskOutsidePolygon と同じ）
+    bool insidePolygon(const glm::vec2& p, std::span<const glm::vec2> poly)
+    {
+        bool inside = false;
+        for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++)
+        {
+            const glm::vec2& a = poly[i];
+            const glm::vec2& b = poly[j];
+            if ((a.y > p.y) != (b.y > p.y) && p.x < a.x + (p.y - a.y) * (b.x - a.x) / (b.y - a.y))
+                inside = !inside;
+        }
+        return inside;
+    }
+
+    bool segmentsIntersect(const glm::vec2& a0, const glm::vec2& a1, const glm::vec2& b0, const glm::vec2& b1)
+    {
+        const glm::vec2 r = a1 - a0;
+        const glm::vec2 s = b1 - b0;
+        const float d = cross(r, s);
+        if (d == 0.0f) return false;    // 平行（重なっていれば頂点の内外判定で拾う）
+
+        const float t = cross(b0 - a0, s) / d;
+        const float u = cross(b0 - a0, r) / d;
+        return t >= 0.0f && t <= 1.0f && u >= 0.0f && u <= 1.0f;
+    }
+
+    /// 辺が交差しなければ、片方がもう片方に含まれるか離れているかのどちらか
+    bool overlaps(std::span<const glm::vec2> a, std::span<const glm::vec2> b)
+    {
+        if (insidePolygon(a[0], b) || insidePolygon(b[0], a)) return true;
+
+        for (size_t i = 0, j = a.size() - 1; i < a.size(); j = i++)
+            for (size_t k = 0, l = b.size() - 1; k < b.size(); l = k++)
+                if (segmentsIntersect(a[j], a[i], b[l], b[k])) return true;
+        return false;
+    }
+}
+
+void region_faces::collect(const EditMesh& mesh, const glm::mat4& vp, int fbW, int fbH,
+    glm::vec2 rectMin, glm::vec2 rectMax, std::span<const glm::vec2> lasso, std::vector<uint32_t>& out)
+{
+    out.clear();
+    if (fbW <= 0 || fbH <= 0 || rectMax.x <= rectMin.x || rectMax.y <= rectMin.y) return;
+
+    const glm::vec2 rect[4] = { rectMin, { rectMax.x, rectMin.y }, rectMax, { rectMin.x, rectMax.y } };
+    const std::span<const glm::vec2> region = lasso.empty() ? std::span<const glm::vec2>(rect) : lasso;
+    if (region.size() < 3) return;
+
+    std::vector<glm::vec4> clip, scratch;
+    std::vector<glm::vec2> screen;
+    for (uint32_t f = 0; f < mesh.faceCount(); ++f)
+    {
+        clip.clear();
+        mesh.forEachFaceVertex(f, [&](uint32_t v) { clip.push_back(vp * glm::vec4(mesh.position(v), 1.0f)); });
+
+        // 画面外・カメラの後ろの部分を落としてから投影する（w > 0 が保証される）
+        for (const glm::vec4& plane : kFrustumPlanes)
+        {
+            clipPlane(clip, plane, scratch);
+            clip.swap(scratch);
+            if (clip.size() < 3) break;
+        }
+        if (clip.size() < 3) continue;
+
+        screen.clear();
+        glm::vec2 smin(1e30f), smax(-1e30f);
+        for (const glm::vec4& c : clip)
+        {
+            if (c.w <= 0.0f) continue;
+            const glm::vec2 p((c.x / c.w * 0.5f + 0.5f) * (float)fbW, (0.5f - c.y / c.w * 0.5f) * (float)fbH);
+            screen.push_back(p);
+            smin = glm::min(smin, p);
+            smax = glm::max(smax, p);
+        }
+        if (screen.size() < 3) continue;
+        if (smax.x < rectMin.x || smin.x > rectMax.x || smax.y < rectMin.y || smin.y > rectMax.y) continue;
+
+        if (overlaps(screen, region)) out.push_back(f + 1);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "cstdint"
+#include "span"
+#include "vector"
+
+#include "glm/glm.hpp"
+
+#include "mesh/edit_mesh.h"
+
+// 範囲選択の CPU 版（隠れた面も含めて、投影した面が範囲に掛かるかを直接調べる）
+namespace region_faces
+{
+    /**
+     * @brief 投影した面が範囲と重なる面の ID を集める
+     *
+     * @param vp       メッシュのローカル空間からクリップ空間への行列（ID バッファと同じ MVP）
+     * @param rectMin, rectMax 範囲の外接矩形（ウィンドウ座標、左上原点）
+     * @param lasso    投げ縄の多角形（空なら矩形そのもの）
+     * @param out      昇順の面 ID（face + 1）
+     *
+     * 面の多角形を同次座標のまま視錐台で切り取ってから画面へ投影し、範囲の多角形と
+     * 交差（頂点の内外・辺どうしの交差）を調べる。深度は見ないので、隠れた面・
+     * 他の面と重なって ID バッファに残らない面もすべて拾う。GL には依存しない。
+     */
+    void collect(const EditMesh& mesh, const glm::mat4& vp, int fbW, int fbH,
+        glm::vec2 rectMin, glm::vec2 rectMax, std::span<const glm::vec2> lasso, std::vector<uint32_t>& out);
+}
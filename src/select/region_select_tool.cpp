@@ -0,0 +1,102 @@
+#include "select/region_select_tool.h"
+
+#include "imgui.h"
+
+void RegionSelectTool::update(GLFWwindow* window)
+{
+    if (!window) return;
+
+    const bool down = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+
+    double x = 0.0, y = 0.0;
+    glfwGetCursorPos(window, &x, &y);
+    const glm::vec2 p((float)x, (float)y);
+
+    if (!m_dragging)
+    {
+        // ImGuiがマウスを使ってるなら開始しない
+        const bool pressed = down && !m_prevDown && !ImGui::GetIO().WantCaptureMouse;
+        const bool shift = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
+            glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS;
+        const bool ctrl = glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS ||
+            glfwGetKey(window, GLFW_KEY_RIGHT_CONTROL) == GLFW_PRESS;
+
+        if (pressed && (shift || ctrl))
+        {
+            m_dragging = true;
+            m_lasso = ctrl;
+            m_start = m_current = p;
+            m_points.clear();
+            m_points.push_back(p);
+        }
+    }
+    else if (down)
+    {
+        m_current = p;
+
+        // 投げ縄は 2px 以上動いたら点を足す
+        if (m_lasso && glm::length(p - m_points.back()) >= 2.0f)
+            m_points.push_back(p);
+    }
+    else
+    {
+        m_dragging = false;
+        m_hasResult = true;
+    }
+
+    m_prevDown = down;
+}
+
+bool RegionSelectTool::takeResult(ScreenRegion& out)
+{
+    if (!m_hasResult) return false;
+    m_hasResult = false;
+
+    out.lasso.clear();
+    if (m_lasso)
+    {
+        if (m_points.size() < 3) return false;
+
+        out.min = out.max = m_points[0];
+        for (const glm::vec2& q : m_points)
+        {
+            out.min = glm::min(out.min, q);
+            out.max = glm::max(out.max, q);
+        }
+        out.lasso = m_points;
+    }
+    else
+    {
+        out.min = glm::min(m_start, m_current);
+        out.max = glm::max(m_start, m_current);
+    }
+
+    // 小さすぎる範囲はクリック扱いにしない（誤操作）
+    const glm::vec2 size = out.max - out.min;
+    return size.x >= 2.0f && size.y >= 2.0f;
+}
+
+void RegionSelectTool::drawOverlay() const
+{
+    if (!m_dragging) return;
+
+    ImDrawList* dl = ImGui::GetForegroundDrawList();
+    const ImU32 fill = IM_COL32(255, 204, 51, 40);
+    const ImU32 line = IM_COL32(255, 204, 51, 220);
+
+    if (m_lasso)
+    {
+        std::vector<ImVec2> pts;
+        pts.reserve(m_points.size());
+        for (const glm::vec2& q : m_points)
+            pts.emplace_back(q.x, q.y);
+        dl->AddPolyline(pts.data(), (int)pts.size(), line, ImDrawFlags_Closed, 1.0f);
+    }
+    else
+    {
+        const glm::vec2 a = glm::min(m_start, m_current);
+        const glm::vec2 b = glm::max(m_start, m_current);
+        dl->AddRectFilled(ImVec2(a.x, a.y), ImVec2(b.x, b.y), fill);
+        dl->AddRect(ImVec2(a.x, a.y), ImVec2(b.x, b.y), line);
+    }
+}
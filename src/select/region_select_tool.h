@@ -0,0 +1,43 @@
+#pragma once
+
+#include "vector"
+
+#include "GLFW/glfw3.h"
+#include "glm/glm.hpp"
+
+// 矩形 / 投げ縄の選択範囲（ウィンドウ座標、左上原点）
+struct ScreenRegion
+{
+    glm::vec2 min{ 0.0f };
+    glm::vec2 max{ 0.0f };
+    std::vector<glm::vec2> lasso;   ///< 空なら矩形
+};
+
+/**
+ * @brief ラバーバンド（矩形）/ 投げ縄選択のドラッグ操作
+ *
+ * - Shift + 左ドラッグ：矩形選択
+ * - Ctrl + 左ドラッグ：投げ縄選択
+ *
+ * ドラッグ中は active() が true になる（カメラ操作・クリック選択を止める用）。
+ * 離した瞬間に takeResult() で範囲を 1 回だけ取り出せる。
+ */
+class RegionSelectTool
+{
+public:
+    void update(GLFWwindow* window);
+    void drawOverlay() const;
+
+    bool active() const { return m_dragging; }
+    bool takeResult(ScreenRegion& out);
+
+private:
+    bool m_prevDown = false;
+    bool m_dragging = false;
+    bool m_lasso = false;
+    bool m_hasResult = false;
+
+    glm::vec2 m_start{ 0.0f };
+    glm::vec2 m_current{ 0.0f };
+    std::vector<glm::vec2> m_points;
+};